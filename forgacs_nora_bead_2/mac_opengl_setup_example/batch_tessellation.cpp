@@ -0,0 +1,275 @@
+//
+//  batch_tessellation.cpp
+//  mac_opengl_setup_example
+//
+
+#include "batch_tessellation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+static GLuint computeProgram = 0;
+static GLint firstCurveLocation, curveCountLocation, segmentsLocation;
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+GLFWwindow* createComputeContext() {
+    if (!glfwInit())
+        return NULL;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "batch tessellation", NULL, NULL);
+    if (window == NULL) {
+        cerr << "Could not create an OpenGL 4.3 core context for the compute shader." << endl;
+        glfwTerminate();
+        return NULL;
+    }
+
+    glfwMakeContextCurrent(window);
+    /* Core profilban a GLEW csak így tölti be a bővítmények függvényeit. */
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) {
+        destroyComputeContext(window);
+        return NULL;
+    }
+    return window;
+}
+
+void destroyComputeContext(GLFWwindow* window) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+bool initComputeTessellation() {
+    ifstream fileStream("shaders/tessellate_compute.glsl", ios::in);
+    stringstream source;
+    source << fileStream.rdbuf();
+    if (!fileStream.is_open() || source.str().empty()) {
+        cerr << "Compute shader source file could not be read." << endl;
+        return false;
+    }
+
+    string sourceString = source.str();
+    const char* sourceText = sourceString.c_str();
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    GLint compiled, linked, logLength;
+
+    glShaderSource(shader, 1, &sourceText, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        vector<char> log(1024);
+        glGetShaderInfoLog(shader, log.size(), &logLength, log.data());
+        cerr << "Compute shader compilation failed: " << log.data() << endl;
+        glDeleteShader(shader);
+        return false;
+    }
+
+    computeProgram = glCreateProgram();
+    glAttachShader(computeProgram, shader);
+    glLinkProgram(computeProgram);
+    glDeleteShader(shader);
+    glGetProgramiv(computeProgram, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        vector<char> log(1024);
+        glGetProgramInfoLog(computeProgram, log.size(), &logLength, log.data());
+        cerr << "Compute program linking failed: " << log.data() << endl;
+        cleanUpComputeTessellation();
+        return false;
+    }
+
+    firstCurveLocation = glGetUniformLocation(computeProgram, "firstCurve");
+    curveCountLocation = glGetUniformLocation(computeProgram, "curveCount");
+    segmentsLocation = glGetUniformLocation(computeProgram, "segments");
+    return true;
+}
+
+void cleanUpComputeTessellation() {
+    if (computeProgram != 0)
+        glDeleteProgram(computeProgram);
+    computeProgram = 0;
+}
+
+/* de Casteljau egy görbe összes mintájára, ugyanazzal a képlettel, mint a compute shader. */
+static void tessellateCurve(const vector<glm::vec3>& controlPoints, GLint segments, glm::vec3* out) {
+    vector<glm::vec3> work(controlPoints.size());
+
+    if (controlPoints.empty()) {
+        fill(out, out + segments + 1, glm::vec3(0.0f));
+        return;
+    }
+
+    for (GLint s = 0; s <= segments; s++) {
+        GLfloat t = (GLfloat)s / segments;
+
+        copy(controlPoints.begin(), controlPoints.end(), work.begin());
+        for (GLint r = work.size() - 1; r > 0; r--)
+            for (GLint i = 0; i < r; i++)
+                work[i] = work[i] * (1.0f - t) + work[i + 1] * t;
+        out[s] = glm::vec3(work[0].x, work[0].y, 0.0f);
+    }
+}
+
+void tessellateBatchCPU(const vector<BezierCurve>& curves, size_t firstCurve, size_t curveCount, GLint segments,
+                        unsigned threads, vector<glm::vec3>& out) {
+    size_t samplesPerCurve = segments + 1;
+
+    out.resize(curveCount * samplesPerCurve);
+
+    auto tessellateSlice = [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++)
+            tessellateCurve(curves[firstCurve + c].controlPoints, segments, &out[c * samplesPerCurve]);
+    };
+
+    threads = max(1u, min(threads, (unsigned)max((size_t)1, curveCount)));
+    vector<thread> workers;
+    size_t perThread = (curveCount + threads - 1) / threads;
+    for (unsigned t = 1; t < threads; t++) {
+        size_t begin = t * perThread, end = min(curveCount, begin + perThread);
+        if (begin < end)
+            workers.push_back(thread(tessellateSlice, begin, end));
+    }
+    tessellateSlice(0, min(curveCount, perThread));
+    for (thread& worker : workers)
+        worker.join();
+}
+
+/* Egy kimeneti puffer a gyűrűben: melyik darab van benne, és mikor lesz kész. */
+struct ReadbackSlot {
+    GLuint buffer;
+    GLsync fence;
+    size_t firstCurve, curveCount;
+};
+
+bool tessellateBatchGPU(const vector<BezierCurve>& curves, GLint segments, BatchChunkHandler handler, void* user,
+                        BatchTessellationStats& outStats) {
+    auto start = chrono::steady_clock::now();
+    size_t samplesPerCurve = segments + 1;
+
+    memset(&outStats, 0, sizeof(outStats));
+    if (computeProgram == 0 || segments < 1)
+        return false;
+
+    /* Minden kontrollpontot egyszer töltünk fel; a túl magas fokszámú görbék 0 hosszú tartományt kapnak. */
+    vector<glm::vec2> points;
+    vector<GLuint> ranges(2 * curves.size());
+    vector<size_t> fallbackCurves;
+    for (size_t c = 0; c < curves.size(); c++) {
+        const vector<glm::vec3>& controlPoints = curves[c].controlPoints;
+
+        ranges[2 * c] = points.size();
+        if (controlPoints.size() > COMPUTE_MAX_DEGREE + 1) {
+            fallbackCurves.push_back(c);
+            ranges[2 * c + 1] = 0;
+            continue;
+        }
+        ranges[2 * c + 1] = controlPoints.size();
+        for (const glm::vec3& p : controlPoints)
+            points.push_back(glm::vec2(p.x, p.y));
+    }
+    if (points.empty())
+        points.push_back(glm::vec2(0.0f));      // üres SSBO-t nem köthetünk
+
+    GLuint inputs[2];
+    glGenBuffers(2, inputs);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputs[0]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, points.size() * sizeof(glm::vec2), points.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputs[1]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, max((size_t)1, ranges.size()) * sizeof(GLuint), ranges.data(), GL_STATIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, inputs[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, inputs[1]);
+    outStats.uploadMs = elapsedMs(start);
+
+    /* Egy darab legfeljebb 65535 munkacsoport lehet (a GL 4.3 által garantált minimum). */
+    size_t chunkCurves = min((size_t)COMPUTE_CHUNK_CURVES, (size_t)65535 * COMPUTE_WORKGROUP_SIZE / samplesPerCurve);
+    size_t chunkBytes = chunkCurves * samplesPerCurve * sizeof(glm::vec2);
+    size_t chunks = (curves.size() + chunkCurves - 1) / chunkCurves;
+
+    ReadbackSlot slots[COMPUTE_READBACK_BUFFERS] = {};
+    for (ReadbackSlot& slot : slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, slot.buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, chunkBytes, NULL, GL_STREAM_READ);
+    }
+
+    glUseProgram(computeProgram);
+    glUniform1ui(segmentsLocation, segments);
+
+    vector<glm::vec3> chunkSamples;
+    auto consume = [&](ReadbackSlot& slot) {
+        auto waitStart = chrono::steady_clock::now();
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+        outStats.waitMs += elapsedMs(waitStart);
+
+        auto readbackStart = chrono::steady_clock::now();
+        size_t bytes = slot.curveCount * samplesPerCurve * sizeof(glm::vec2);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, slot.buffer);
+        const glm::vec2* mapped = (const glm::vec2*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+        chunkSamples.resize(slot.curveCount * samplesPerCurve);
+        for (size_t i = 0; i < chunkSamples.size(); i++)
+            chunkSamples[i] = glm::vec3(mapped[i].x, mapped[i].y, 0.0f);
+        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        outStats.bytesRead += bytes;
+
+        /* A GPU-n kihagyott görbéket itt pótoljuk. */
+        auto first = lower_bound(fallbackCurves.begin(), fallbackCurves.end(), slot.firstCurve);
+        for (auto it = first; it != fallbackCurves.end() && *it < slot.firstCurve + slot.curveCount; ++it) {
+            tessellateCurve(curves[*it].controlPoints, segments, &chunkSamples[(*it - slot.firstCurve) * samplesPerCurve]);
+            outStats.cpuFallbackCurves++;
+        }
+        outStats.readbackMs += elapsedMs(readbackStart);
+
+        auto handlerStart = chrono::steady_clock::now();
+        handler(slot.firstCurve, slot.curveCount, chunkSamples, user);
+        outStats.handlerMs += elapsedMs(handlerStart);
+    };
+
+    /* A k. darab indítása előtt a gyűrűben ugyanazt a puffert használó (k - N). darabot olvassuk vissza; addig a GPU
+       a közben elindított darabokon dolgozik. */
+    for (size_t k = 0; k < chunks; k++) {
+        ReadbackSlot& slot = slots[k % COMPUTE_READBACK_BUFFERS];
+        if (slot.fence != 0)
+            consume(slot);
+
+        slot.firstCurve = k * chunkCurves;
+        slot.curveCount = min(chunkCurves, curves.size() - slot.firstCurve);
+        GLuint invocations = slot.curveCount * samplesPerCurve;
+
+        auto dispatchStart = chrono::steady_clock::now();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, slot.buffer);
+        glUniform1ui(firstCurveLocation, slot.firstCurve);
+        glUniform1ui(curveCountLocation, slot.curveCount);
+        glDispatchCompute((invocations + COMPUTE_WORKGROUP_SIZE - 1) / COMPUTE_WORKGROUP_SIZE, 1, 1);
+        /* A shader írásai csak e korlát után láthatók a glMapBufferRange számára. */
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        outStats.dispatchMs += elapsedMs(dispatchStart);
+        outStats.chunks++;
+    }
+    for (size_t k = chunks > COMPUTE_READBACK_BUFFERS ? chunks - COMPUTE_READBACK_BUFFERS : 0; k < chunks; k++)
+        consume(slots[k % COMPUTE_READBACK_BUFFERS]);
+
+    for (ReadbackSlot& slot : slots)
+        glDeleteBuffers(1, &slot.buffer);
+    glDeleteBuffers(2, inputs);
+    glUseProgram(0);
+
+    outStats.totalMs = elapsedMs(start);
+    return glGetError() == GL_NO_ERROR;
+}
@@ -0,0 +1,65 @@
+//
+//  batch_tessellation.h
+//  mac_opengl_setup_example
+//
+//  Bulk conversion of curves to fixed-resolution polylines: a multithreaded CPU path and a GL 4.3
+//  compute shader path that uploads every control point once to a shader storage buffer and reads
+//  the samples back in chunks, asynchronously.
+//
+
+#ifndef batch_tessellation_h
+#define batch_tessellation_h
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "bezier.h"
+
+/* A compute shader helyi tömbje ekkora fokszámig elég; a magasabb fokszámú görbéket a CPU pótolja. */
+#define COMPUTE_MAX_DEGREE 31
+#define COMPUTE_WORKGROUP_SIZE 64
+
+/* Egy dispatch legfeljebb ennyi görbét dolgoz fel, és ennyi kimeneti puffer forog, hogy a GPU a következő
+   darabon dolgozzon, amíg a CPU az előzőt olvassa vissza. */
+#define COMPUTE_CHUNK_CURVES 16384
+#define COMPUTE_READBACK_BUFFERS 3
+
+/* Each phase is timed on its own on the calling thread; the GPU keeps working while the handler runs,
+   so totalMs (wall clock) is less than or equal to the sum of the phases. */
+struct BatchTessellationStats {
+    size_t chunks;
+    size_t bytesRead;
+    size_t cpuFallbackCurves;   // curves above COMPUTE_MAX_DEGREE, tessellated on the CPU
+    double uploadMs;
+    double dispatchMs;          // glDispatchCompute, barrier, fence and flush (software drivers may compute here)
+    double waitMs;              // time spent blocked on a chunk that was not finished yet
+    double readbackMs;          // mapping the chunk, copying it out and the CPU fallback curves
+    double handlerMs;
+    double totalMs;
+};
+
+/* Called for every chunk, in order: the samples of curves [firstCurve, firstCurve + curveCount),
+   segments + 1 per curve. The vector is reused for the next chunk after the call returns. */
+typedef void (*BatchChunkHandler)(size_t firstCurve, size_t curveCount, const std::vector<glm::vec3>& samples, void* user);
+
+/* Hidden window with a GL 4.3 core context for the compute path; NULL if the driver cannot provide one
+   (macOS stops at 4.1). The interactive window keeps requesting 3.3. */
+GLFWwindow* createComputeContext();
+void destroyComputeContext(GLFWwindow* window);
+
+/* Compiles shaders/tessellate_compute.glsl; needs a current GL 4.3 context. */
+bool initComputeTessellation();
+void cleanUpComputeTessellation();
+
+/* segments + 1 samples per curve (de Casteljau) for the curves [firstCurve, firstCurve + curveCount),
+   split between threads. Empty curves give zeros. */
+void tessellateBatchCPU(const std::vector<BezierCurve>& curves, size_t firstCurve, size_t curveCount, GLint segments,
+                        unsigned threads, std::vector<glm::vec3>& out);
+
+bool tessellateBatchGPU(const std::vector<BezierCurve>& curves, GLint segments, BatchChunkHandler handler, void* user,
+                        BatchTessellationStats& outStats);
+
+#endif /* batch_tessellation_h */
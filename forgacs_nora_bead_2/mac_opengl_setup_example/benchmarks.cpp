@@ -0,0 +1,670 @@
+//
+//  benchmarks.cpp
+//  mac_opengl_setup_example
+//
+
+#include "batch_tessellation.h"
+#include "benchmarks.h"
+#include "bezier.h"
+#include "cubic_approx.h"
+#include "export.h"
+#include "intersect.h"
+#include "patch.h"
+#include "simplify.h"
+#include "tessellation_cache.h"
+#include "tessellation_worker.h"
+#include "vertex_format.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* Ennyi szakaszra bontunk egy görbét a mérésekben (a legnagyobb LOD). */
+#define BENCH_SEGMENTS 256
+
+static double elapsedMicroseconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+static vector<glm::vec3> randomCurve(mt19937& rng, int degree) {
+    uniform_real_distribution<GLfloat> coordinate(-1.0f, 1.0f);
+    vector<glm::vec3> controlPoints;
+
+    for (int i = 0; i <= degree; i++)
+        controlPoints.push_back(glm::vec3(coordinate(rng), coordinate(rng), 0.0f));
+    return controlPoints;
+}
+
+/* Pontos vs. köbös közelítéssel rajzolt görbe: hiba és sebesség a fokszám függvényében. */
+static int benchmarkCubicApproximation() {
+    const int     degrees[] = { 3, 4, 6, 8, 12, 16, 24, 32 };
+    const int     curvesPerDegree = 50;
+    const GLfloat tolerance = 1.0f / 1024.0f;   // ~0.3 px in a 600 px window at zoom 1
+
+    cout << "tolerance " << tolerance << ", " << BENCH_SEGMENTS << " segments per curve, "
+         << curvesPerDegree << " random curves per degree" << endl;
+    cout << setw(6) << "degree" << setw(12) << "exact us" << setw(12) << "build us" << setw(12) << "cubic us"
+         << setw(10) << "speedup" << setw(8) << "pieces" << setw(12) << "bound" << setw(12) << "measured" << endl;
+
+    for (int degree : degrees) {
+        mt19937 rng(degree);
+        vector<vector<glm::vec3>> curves;
+        for (int c = 0; c < curvesPerDegree; c++)
+            curves.push_back(randomCurve(rng, degree));
+
+        vector<glm::vec3> out;
+        auto start = chrono::steady_clock::now();
+        for (const vector<glm::vec3>& curve : curves) {
+            out.clear();
+            tessellateBezier(curve, BENCH_SEGMENTS, out);
+        }
+        double exactTime = elapsedMicroseconds(start) / curvesPerDegree;
+
+        vector<CubicApproximation> approximations(curvesPerDegree);
+        start = chrono::steady_clock::now();
+        for (int c = 0; c < curvesPerDegree; c++)
+            updateCubicApproximation(approximations[c], curves[c], tolerance);
+        double buildTime = elapsedMicroseconds(start) / curvesPerDegree;
+
+        start = chrono::steady_clock::now();
+        for (const CubicApproximation& approx : approximations) {
+            out.clear();
+            tessellateCubics(approx.pieces, BENCH_SEGMENTS, out);
+        }
+        double cubicTime = elapsedMicroseconds(start) / curvesPerDegree;
+
+        /* A tényleges (parametrikus) hibát sűrű mintavétellel mérjük a darabok paramétertartományán. */
+        GLfloat bound = 0.0f, measured = 0.0f;
+        size_t  pieces = 0;
+        for (int c = 0; c < curvesPerDegree; c++) {
+            const CubicApproximation& approx = approximations[c];
+            GLint pieceCount = approx.pieces.size() / 4;
+
+            for (GLint k = 0; k < pieceCount; k++)
+                for (int j = 0; j <= 32; j++) {
+                    GLfloat u = j / 32.0f;
+                    GLfloat t = approx.knots[k] + u * (approx.knots[k + 1] - approx.knots[k]);
+                    glm::vec3 d = evaluateBezier(curves[c], t) - evaluateCubic(&approx.pieces[4 * k], u);
+                    measured = fmaxf(measured, glm::length(d));
+                }
+
+            bound = fmaxf(bound, approx.error);
+            pieces += pieceCount;
+        }
+
+        cout << setw(6) << degree << fixed << setprecision(2) << setw(12) << exactTime << setw(12) << buildTime
+             << setw(12) << cubicTime << setw(9) << exactTime / cubicTime << "x" << setprecision(1)
+             << setw(8) << (double)pieces / curvesPerDegree << scientific << setprecision(2)
+             << setw(12) << bound << setw(12) << measured << defaultfloat << endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Véletlen jelenet count görbével egy kb. négyzet alakú területen, ahogy a --scene is készíti. */
+static vector<BezierCurve> randomScene(mt19937& rng, int count) {
+    GLfloat side = 2.0f * sqrtf((GLfloat)count);
+    uniform_real_distribution<GLfloat> position(-side / 2.0f, side / 2.0f);
+    uniform_int_distribution<int> degree(3, 6);
+    vector<BezierCurve> curves(count);
+
+    for (BezierCurve& curve : curves) {
+        glm::vec3 origin = glm::vec3(position(rng), position(rng), 0.0f);
+        curve.controlPoints = randomCurve(rng, degree(rng));
+        for (glm::vec3& p : curve.controlPoints)
+            p = origin + p * 0.75f;
+    }
+    return curves;
+}
+
+/* Rejtett ablak 3.3-as kontextussal a feltöltések méréséhez; NULL, ha nincs megjeleníthető OpenGL. */
+static GLFWwindow* createUploadContext() {
+    if (!glfwInit())
+        return NULL;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "upload benchmark", NULL, NULL);
+    if (window == NULL) {
+        glfwTerminate();
+        return NULL;
+    }
+    glfwMakeContextCurrent(window);
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return NULL;
+    }
+    return window;
+}
+
+/* A képkocka minden feltöltendő bájtja: a kódolt vertexek, int16-nál a kvantálási táblák is. */
+static size_t frameUploadBytes(const GeometryFrame& frame) {
+    return frame.packed.size() + (frame.format == VERTEX_INT16 ? frame.quantization.size() * sizeof(glm::vec4)
+           + (frame.quantizationFirsts.size() + frame.quantizationBlocks.size()) * sizeof(GLint) : 0);
+}
+
+/* Feltöltés úgy, ahogy az updateVBO csinálja, glFinish-sel lezárva; MiB/s. */
+static double measureUpload(const GeometryFrame& frame, GLuint buffers[4]) {
+    const int repeats = 20;
+    const void* data[4] = { frame.packed.data(), frame.quantization.data(), frame.quantizationFirsts.data(), frame.quantizationBlocks.data() };
+    size_t sizes[4] = { frame.packed.size(), frame.quantization.size() * sizeof(glm::vec4),
+                        frame.quantizationFirsts.size() * sizeof(GLint), frame.quantizationBlocks.size() * sizeof(GLint) };
+    int uploads = frame.format == VERTEX_INT16 ? 4 : 1;
+
+    glFinish();
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int i = 0; i < uploads; i++) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            glBufferData(GL_ARRAY_BUFFER, sizes[i], data[i], GL_STATIC_DRAW);
+        }
+        glFinish();
+    }
+    double seconds = elapsedMicroseconds(start) / 1e6;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return frameUploadBytes(frame) * repeats / seconds / (1024.0 * 1024.0);
+}
+
+/* A vertex shader dobozkeresése a CPU-n; int16-nál így a keresőtáblákat is ellenőrizzük. */
+static size_t quantizationRange(const GeometryFrame& frame, GLint vertex, size_t range) {
+    if (frame.format != VERTEX_INT16)
+        return range;
+
+    GLint found = frame.quantizationBlocks[vertex >> QUANTIZATION_BLOCK_SHIFT];
+    while (frame.quantizationFirsts[found + 1] <= vertex)
+        found++;
+    return found;
+}
+
+/* Egy teljes képkocka vertexadata az egyes formátumokban: méret, mért feltöltési sávszélesség, kódolási idő,
+   hibakorlát és mért hiba. */
+static int benchmarkVertexFormats() {
+    const int sceneSizes[] = { 1000, 10000, 100000 };
+    const int width = 1920, height = 1080;
+    GLuint buffers[4];
+
+    GLFWwindow* context = createUploadContext();
+    if (context != NULL) {
+        glGenBuffers(4, buffers);
+        cout << glGetString(GL_RENDERER) << ", upload = glBufferData of the frame followed by glFinish" << endl;
+    }
+    else
+        cout << "no OpenGL context, upload bandwidth not measured" << endl;
+
+    cout << width << "x" << height << " view, the whole scene visible; @60Hz is the bandwidth needed for a new frame"
+         << " every 1/60 s (estimate)" << endl;
+    cout << setw(8) << "curves" << setw(8) << "format" << setw(12) << "vertices" << setw(12) << "KiB/frame"
+         << setw(13) << "MiB/s @60Hz" << setw(14) << "upload MiB/s" << setw(11) << "upload us" << setw(12) << "encode us"
+         << setw(12) << "bound px" << setw(12) << "measured px" << endl;
+
+    for (int count : sceneSizes) {
+        mt19937 rng(count);
+        vector<BezierCurve> curves = randomScene(rng, count);
+        GLfloat side = 2.0f * sqrtf((GLfloat)count) + 2.0f;
+        Camera camera = { glm::vec2(0.0f, 0.0f), 2.0f / side };
+
+        GeometryFrame frame;
+        tessellateScene(curves, camera, width, height, SIMPLIFY_NONE, frame);
+        GLfloat pixelsPerUnit = pixelsPerWorldUnit(camera, width, height);
+
+        for (int f = 0; f < VERTEX_FORMAT_COUNT; f++) {
+            VertexFormat format = (VertexFormat)f;
+
+            auto start = chrono::steady_clock::now();
+            encodeFrame(frame, format, camera, width, height);
+            double encodeTime = elapsedMicroseconds(start);
+
+            /* Dekódolva visszamérjük az eltérést, és ellenőrizzük, hogy a korláton belül marad. */
+            GLfloat measured = 0.0f;
+            for (size_t r = 0; r < frame.curveFirsts.size(); r++) {
+                GLint last = frame.pointFirsts[r] + frame.pointCounts[r];
+                for (GLint i = frame.curveFirsts[r]; i < last; i++) {
+                    glm::vec2 decoded = decodeVertex(frame.format, frame.packed, i, frame.quantization[quantizationRange(frame, i, r)]);
+                    measured = fmaxf(measured, fmaxf(fabsf(decoded.x - frame.vertices[i].x), fabsf(decoded.y - frame.vertices[i].y)));
+                }
+            }
+
+            double kib = frameUploadBytes(frame) / 1024.0;
+            cout << setw(8) << count << setw(8) << vertexFormatName(format) << setw(12) << frame.vertices.size()
+                 << fixed << setprecision(1) << setw(12) << kib << setw(13) << kib * 60.0 / 1024.0;
+            if (context != NULL) {
+                double bandwidth = measureUpload(frame, buffers);
+                cout << setw(14) << bandwidth << setw(11) << kib / 1024.0 / bandwidth * 1e6;
+            }
+            else
+                cout << setw(14) << "-" << setw(11) << "-";
+            cout << setw(12) << encodeTime << scientific << setprecision(2)
+                 << setw(12) << frame.errorBound * pixelsPerUnit << setw(12) << measured * pixelsPerUnit << defaultfloat;
+            if (frame.format != format)
+                cout << "  (fell back to " << vertexFormatName(frame.format) << ")";
+            if (measured > frame.errorBound * 1.001f)
+                cout << "  ERROR BOUND EXCEEDED";
+            cout << endl;
+        }
+    }
+
+    if (context != NULL) {
+        glDeleteBuffers(4, buffers);
+        glfwDestroyWindow(context);
+        glfwTerminate();
+    }
+    return EXIT_SUCCESS;
+}
+
+static BezierPatch randomPatch(mt19937& rng, GLint degree) {
+    uniform_real_distribution<GLfloat> jitter(-0.1f, 0.1f);
+    BezierPatch patch = { degree, degree };
+
+    for (GLint a = 0; a <= degree; a++)
+        for (GLint b = 0; b <= degree; b++)
+            patch.controlPoints.push_back(glm::vec3(2.0f * a / degree - 1.0f + jitter(rng),
+                                                    2.0f * b / degree - 1.0f + jitter(rng), 5.0f * jitter(rng)));
+    return patch;
+}
+
+static GLfloat maxDistance(const vector<glm::vec3>& a, const vector<glm::vec3>& b) {
+    GLfloat distance = 0.0f;
+
+    for (size_t i = 0; i < a.size(); i++)
+        distance = fmaxf(distance, glm::length(a[i] - b[i]));
+    return distance;
+}
+
+/* Naiv (mintánkénti NCR/pow) és szeparált tesszelálás, valamint egy kontrollpont mozgatásának részleges frissítése. */
+static int benchmarkPatchTessellation() {
+    const GLint degrees[] = { 3, 7 };
+    const GLint resolutions[] = { 64, 128, 256, 512 };
+    const int   moves = 20;
+
+    cout << setw(6) << "degree" << setw(6) << "grid" << setw(12) << "naive ms" << setw(12) << "table ms"
+         << setw(12) << "full ms" << setw(14) << "center ms" << setw(10) << "verts%" << setw(14) << "corner ms"
+         << setw(10) << "verts%" << setw(12) << "error" << endl;
+
+    for (GLint degree : degrees)
+        for (GLint resolution : resolutions) {
+            mt19937 rng(degree * 1000 + resolution);
+            BezierPatch patch = randomPatch(rng, degree);
+            PatchTessellation tess, reference;
+            vector<glm::vec3> naive;
+
+            auto start = chrono::steady_clock::now();
+            tessellatePatchNaive(patch, resolution, resolution, naive);
+            double naiveTime = elapsedMicroseconds(start) / 1000.0;
+
+            start = chrono::steady_clock::now();
+            basisTable(degree, resolution);
+            double tableTime = elapsedMicroseconds(start) / 1000.0;
+
+            start = chrono::steady_clock::now();
+            tessellatePatch(patch, resolution, resolution, tess);
+            double fullTime = elapsedMicroseconds(start) / 1000.0;
+            GLfloat error = maxDistance(tess.vertices, naive);
+
+            /* Egy belső és egy sarokhoz közeli kontrollpontot mozgatunk apró lépésekben, mint húzáskor. */
+            double moveTime[2] = { 0.0, 0.0 };
+            size_t recomputed[2] = { 0, 0 };
+            const GLint targets[2][2] = { { degree / 2, degree / 2 }, { 0, 1 } };
+            for (int k = 0; k < 2; k++)
+                for (int m = 0; m < moves; m++) {
+                    GLint a = targets[k][0], b = targets[k][1];
+                    glm::vec3 position = patch.controlPoints[a * (degree + 1) + b] + glm::vec3(0.001f, -0.001f, 0.0f);
+
+                    start = chrono::steady_clock::now();
+                    recomputed[k] += movePatchControlPoint(patch, a, b, position, tess);
+                    moveTime[k] += elapsedMicroseconds(start) / 1000.0 / moves;
+                }
+
+            /* A részleges frissítések után is a teljes újraszámolás eredményét kell kapnunk (a korláton belül). */
+            tessellatePatch(patch, resolution, resolution, reference);
+            error = fmaxf(error, maxDistance(tess.vertices, reference.vertices));
+
+            double total = (double)tess.vertices.size() * moves;
+            cout << setw(6) << degree << setw(6) << resolution << fixed << setprecision(3) << setw(12) << naiveTime
+                 << setw(12) << tableTime << setw(12) << fullTime << setw(14) << moveTime[0] << setprecision(1)
+                 << setw(10) << 100.0 * recomputed[0] / total << setprecision(3) << setw(14) << moveTime[1]
+                 << setprecision(1) << setw(10) << 100.0 * recomputed[1] / total << scientific << setprecision(2)
+                 << setw(12) << error << defaultfloat << endl;
+        }
+    return EXIT_SUCCESS;
+}
+
+/* Szakaszonként ennyi darabra bontott görbék a poligon-alapú összehasonlításban. */
+#define POLYLINE_SEGMENTS 32
+
+/* A visszaadott paraméterek pontosságát a float kiértékelés hibájától függetlenül, double-ben mérjük. */
+static void evaluateBezierDouble(const vector<glm::vec3>& controlPoints, double t, double& outX, double& outY) {
+    vector<double> x, y;
+    for (const glm::vec3& p : controlPoints) {
+        x.push_back(p.x);
+        y.push_back(p.y);
+    }
+    for (size_t r = controlPoints.size() - 1; r > 0; r--)
+        for (size_t i = 0; i < r; i++) {
+            x[i] = x[i] * (1.0 - t) + x[i + 1] * t;
+            y[i] = y[i] * (1.0 - t) + y[i + 1] * t;
+        }
+    outX = x[0];
+    outY = y[0];
+}
+
+/* Half-open in both parameters, so that a crossing at a shared polyline vertex is counted once. */
+static bool segmentsCross(glm::vec3 p0, glm::vec3 p1, glm::vec3 q0, glm::vec3 q1) {
+    glm::vec2 r = glm::vec2(p1 - p0), s = glm::vec2(q1 - q0), w = glm::vec2(q0 - p0);
+    GLfloat denom = r.x * s.y - r.y * s.x;
+    if (denom == 0.0f)
+        return false;
+
+    GLfloat u = (w.x * s.y - w.y * s.x) / denom, v = (w.x * r.y - w.y * r.x) / denom;
+    return u >= 0.0f && u < 1.0f && v >= 0.0f && v < 1.0f;
+}
+
+static size_t countPolylineCrossings(const vector<glm::vec3>& a, const vector<glm::vec3>& b) {
+    size_t count = 0;
+
+    for (size_t i = 0; i + 1 < a.size(); i++)
+        for (size_t j = 0; j + 1 < b.size(); j++)
+            if (segmentsCross(a[i], a[i + 1], b[j], b[j + 1]))
+                count++;
+    return count;
+}
+
+/* Minden tesszelált szakasz minden másikkal, szűrés + szakaszok, illetve szűrés + Bézier-vágás a kontrollpoligonokon. */
+static int benchmarkIntersections() {
+    const int   sceneSizes[] = { 250, 1000, 4000, 16000 };
+    const int   naiveLimit = 1000;
+    const int   segmentQueries = 200;
+
+    cout << "tolerance " << INTERSECT_TOLERANCE << ", " << POLYLINE_SEGMENTS << " segments per curve for the polyline methods" << endl;
+    cout << setw(7) << "curves" << setw(10) << "pairs" << setw(12) << "naive ms" << setw(12) << "poly ms" << setw(10) << "poly hits"
+         << setw(12) << "clip ms" << setw(10) << "clip hits" << setw(10) << "clips" << setw(10) << "splits"
+         << setw(11) << "exhausted" << setw(12) << "residual" << setw(12) << "line us" << setw(11) << "line exh." << endl;
+
+    for (int count : sceneSizes) {
+        mt19937 rng(count);
+        vector<BezierCurve> curves = randomScene(rng, count);
+        vector<vector<glm::vec3>> polylines(curves.size());
+        for (size_t i = 0; i < curves.size(); i++)
+            tessellateBezier(curves[i].controlPoints, POLYLINE_SEGMENTS, polylines[i]);
+
+        vector<pair<GLint, GLint>> pairs;
+        size_t polylineHits = 0;
+        auto start = chrono::steady_clock::now();
+        findCandidatePairs(curves, INTERSECT_TOLERANCE, pairs);
+        for (const pair<GLint, GLint>& candidate : pairs)
+            polylineHits += countPolylineCrossings(polylines[candidate.first], polylines[candidate.second]);
+        double polylineTime = elapsedMicroseconds(start) / 1000.0;
+
+        double naiveTime = -1.0;
+        if (count <= naiveLimit) {
+            size_t naiveHits = 0;
+            start = chrono::steady_clock::now();
+            for (size_t i = 0; i < polylines.size(); i++)
+                for (size_t j = i + 1; j < polylines.size(); j++)
+                    naiveHits += countPolylineCrossings(polylines[i], polylines[j]);
+            naiveTime = elapsedMicroseconds(start) / 1000.0;
+
+            /* A dobozszűrés nem hagyhat ki metszést. */
+            if (naiveHits != polylineHits)
+                cerr << "broad phase lost crossings: " << naiveHits << " vs " << polylineHits << endl;
+        }
+
+        vector<CurveIntersection> hits;
+        IntersectionStats stats;
+        start = chrono::steady_clock::now();
+        findSceneIntersections(curves, INTERSECT_TOLERANCE, hits, &stats);
+        double clipTime = elapsedMicroseconds(start) / 1000.0;
+
+        double residual = 0.0;
+        for (const CurveIntersection& hit : hits) {
+            double ax, ay, bx, by;
+            evaluateBezierDouble(curves[hit.curveA].controlPoints, hit.tA, ax, ay);
+            evaluateBezierDouble(curves[hit.curveB].controlPoints, hit.tB, bx, by);
+            residual = fmax(residual, hypot(ax - bx, ay - by));
+        }
+
+        /* Kijelölő vonalak: véletlen, 4 egység hosszú szakaszok a jelenet területén. */
+        GLfloat side = 2.0f * sqrtf((GLfloat)count);
+        uniform_real_distribution<GLfloat> position(-side / 2.0f, side / 2.0f), angle(0.0f, 6.2831853f);
+        vector<SegmentIntersection> segmentHits;
+        IntersectionStats lineStats;
+        start = chrono::steady_clock::now();
+        for (int q = 0; q < segmentQueries; q++) {
+            glm::vec2 p0 = glm::vec2(position(rng), position(rng));
+            GLfloat a = angle(rng);
+            findSegmentIntersections(curves, p0, p0 + 4.0f * glm::vec2(cosf(a), sinf(a)), INTERSECT_TOLERANCE, segmentHits, &lineStats);
+        }
+        double lineTime = elapsedMicroseconds(start) / segmentQueries;
+
+        cout << setw(7) << count << setw(10) << pairs.size() << fixed << setprecision(1);
+        if (naiveTime >= 0.0)
+            cout << setw(12) << naiveTime;
+        else
+            cout << setw(12) << "-";
+        cout << setw(12) << polylineTime << setw(10) << polylineHits << setw(12) << clipTime << setw(10) << hits.size()
+             << setw(10) << stats.clips << setw(10) << stats.splits << setw(11) << stats.exhausted << scientific
+             << setprecision(2) << setw(12) << residual << fixed << setprecision(1) << setw(12) << lineTime
+             << setw(11) << lineStats.exhausted << defaultfloat << endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Az export útvonala (görbénként 101 pontos tesszelálás) mindkét módszerrel, több tűréssel, egy és az összes szálon. */
+static int benchmarkSimplification() {
+    const int     curveCount = 20000;
+    const GLfloat tolerances[] = { 1e-4f, 1e-3f, 1e-2f };
+    const SimplifyMethod methods[] = { SIMPLIFY_DOUGLAS_PEUCKER, SIMPLIFY_VISVALINGAM };
+    unsigned threads = max(1u, thread::hardware_concurrency());
+
+    mt19937 rng(curveCount);
+    vector<BezierCurve> curves = randomScene(rng, curveCount);
+    vector<glm::vec3> vertices;
+    vector<GLint> firsts;
+    vector<GLsizei> counts;
+    for (const BezierCurve& curve : curves) {
+        firsts.push_back(vertices.size());
+        tessellateBezier(curve.controlPoints, 100, vertices);
+        counts.push_back(vertices.size() - firsts.back());
+    }
+
+    cout << curveCount << " curves, " << vertices.size() << " vertices (" << vertices.size() * sizeof(glm::vec3) / 1024
+         << " KiB as float3), " << threads << " threads" << endl;
+    cout << setw(16) << "method" << setw(10) << "tolerance" << setw(10) << "vertices" << setw(9) << "fewer%"
+         << setw(10) << "KiB" << setw(12) << "1 thread ms" << setw(12) << "all ms" << setw(12) << "max error" << endl;
+
+    for (SimplifyMethod method : methods)
+        for (GLfloat tolerance : tolerances) {
+            vector<unsigned char> keep;
+
+            auto start = chrono::steady_clock::now();
+            simplifyRanges(vertices, firsts, counts, tolerance, method, 1, keep);
+            double singleTime = elapsedMicroseconds(start) / 1000.0;
+
+            start = chrono::steady_clock::now();
+            simplifyRanges(vertices, firsts, counts, tolerance, method, threads, keep);
+            double parallelTime = elapsedMicroseconds(start) / 1000.0;
+
+            size_t kept = 0;
+            GLfloat error = 0.0f;
+            for (size_t i = 0; i < firsts.size(); i++) {
+                for (GLsizei v = 0; v < counts[i]; v++)
+                    kept += keep[firsts[i] + v];
+                error = fmaxf(error, simplificationError(&vertices[firsts[i]], counts[i], &keep[firsts[i]]));
+            }
+
+            cout << setw(16) << simplifyMethodName(method) << setw(10) << tolerance << setw(10) << kept << fixed
+                 << setprecision(1) << setw(9) << 100.0 * (vertices.size() - kept) / vertices.size() << setw(10)
+                 << kept * sizeof(glm::vec3) / 1024.0 << setprecision(2) << setw(12) << singleTime << setw(12) << parallelTime
+                 << scientific << setprecision(2) << setw(12) << error << defaultfloat << endl;
+            if (error > tolerance)
+                cerr << "error bound exceeded" << endl;
+        }
+    return EXIT_SUCCESS;
+}
+
+/* Képkockánkénti tesszelálás gyorsítótár nélkül és gyorsítótárral, a szerkesztés jellemző mintáival. */
+static int benchmarkTessellationCache() {
+    const int    curveCount = 2000;
+    const int    frames = 50;
+    const int    width = 1920, height = 1080;
+    const size_t budgets[] = { 0, 256u << 10, TESSELLATION_CACHE_BUDGET };
+    const char*  scenarios[] = { "rebuild", "drag back", "duplicates" };
+
+    cout << curveCount << " curves, " << frames << " frames per scenario, " << width << "x" << height << " view" << endl;
+    cout << setw(12) << "scenario" << setw(10) << "budget" << setw(12) << "frame ms" << setw(10) << "hits"
+         << setw(10) << "misses" << setw(11) << "evictions" << setw(10) << "KiB" << endl;
+
+    for (int scenario = 0; scenario < 3; scenario++)
+        for (size_t budget : budgets) {
+            mt19937 rng(curveCount);
+            vector<BezierCurve> curves = randomScene(rng, curveCount);
+
+            /* Minden görbéből négy azonos példány, mintha másolással készült volna a jelenet. */
+            if (scenario == 2)
+                for (int c = 0; c < curveCount; c++)
+                    for (int copy = 0; copy < 3; copy++)
+                        curves.push_back(curves[c]);
+
+            GLfloat side = 2.0f * sqrtf((GLfloat)curveCount) + 2.0f;
+            Camera camera = { glm::vec2(0.0f, 0.0f), 2.0f / side };
+            glm::vec3 home = curves[0].controlPoints[1];
+            GeometryFrame frame;
+
+            clearTessellationCache();
+            setTessellationCacheBudget(budget);
+            resetTessellationCacheStats();
+
+            auto start = chrono::steady_clock::now();
+            for (int f = 0; f < frames; f++) {
+                /* Egy kontrollpontot elhúzunk, majd visszaviszünk: két alak váltakozik. */
+                if (scenario == 1)
+                    curves[0].controlPoints[1] = home + glm::vec3(f % 2 ? 0.5f : 0.0f, 0.0f, 0.0f);
+                tessellateScene(curves, camera, width, height, SIMPLIFY_DOUGLAS_PEUCKER, frame);
+            }
+            double frameTime = elapsedMicroseconds(start) / 1000.0 / frames;
+
+            TessellationCacheStats stats = tessellationCacheStats();
+            cout << setw(12) << scenarios[scenario] << setw(10) << budget / 1024 << fixed << setprecision(3)
+                 << setw(12) << frameTime << defaultfloat << setw(10) << stats.hits << setw(10) << stats.misses
+                 << setw(11) << stats.evictions << setw(10) << stats.bytes / 1024 << endl;
+        }
+
+    clearTessellationCache();
+    setTessellationCacheBudget(TESSELLATION_CACHE_BUDGET);
+    return EXIT_SUCCESS;
+}
+
+struct ComputeComparison {
+    const vector<glm::vec3>* reference;
+    size_t samplesPerCurve;
+    GLfloat maxDifference;
+};
+
+static void compareChunk(size_t firstCurve, size_t curveCount, const vector<glm::vec3>& samples, void* user) {
+    ComputeComparison& comparison = *(ComputeComparison*)user;
+    const glm::vec3* reference = comparison.reference->data() + firstCurve * comparison.samplesPerCurve;
+
+    for (size_t i = 0; i < curveCount * comparison.samplesPerCurve; i++)
+        comparison.maxDifference = fmaxf(comparison.maxDifference, glm::length(glm::vec2(samples[i] - reference[i])));
+}
+
+/* Az export tesszelálása: CPU egy szálon, CPU minden szálon és compute shader (feltöltés, várakozás, teljes idő). */
+static int benchmarkComputeTessellation() {
+    const int sceneSizes[] = { 10000, 50000, 200000 };
+    const unsigned threads = max(1u, thread::hardware_concurrency());
+
+    GLFWwindow* context = createComputeContext();
+    if (context == NULL || !initComputeTessellation()) {
+        cerr << "no OpenGL 4.3 context, only the CPU path is measured" << endl;
+        if (context != NULL)
+            destroyComputeContext(context);
+        context = NULL;
+    }
+    else
+        cout << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION) << endl;
+
+    cout << EXPORT_SEGMENTS << " segments per curve, degrees 3-6 and one degree " << COMPUTE_MAX_DEGREE + 9
+         << " curve in every 1000 (CPU fallback), " << threads << " threads" << endl;
+    cout << "gpu ms = upload + dispatch + wait + readback, each timed on its own; wall ms also includes the comparison"
+         << " of every chunk with the CPU samples" << endl;
+    cout << setw(8) << "curves" << setw(12) << "1 thread ms" << setw(10) << "all ms" << setw(12) << "cpu Msmp/s"
+         << setw(10) << "gpu ms" << setw(11) << "upload ms" << setw(13) << "dispatch ms" << setw(10) << "wait ms"
+         << setw(13) << "readback ms" << setw(10) << "wall ms" << setw(8) << "chunks" << setw(12) << "gpu Msmp/s"
+         << setw(12) << "max diff" << endl;
+
+    for (int count : sceneSizes) {
+        mt19937 rng(count);
+        vector<BezierCurve> curves = randomScene(rng, count);
+        for (int c = 0; c < count; c += 1000)
+            curves[c].controlPoints = randomCurve(rng, COMPUTE_MAX_DEGREE + 9);
+
+        vector<glm::vec3> reference;
+        auto start = chrono::steady_clock::now();
+        tessellateBatchCPU(curves, 0, curves.size(), EXPORT_SEGMENTS, 1, reference);
+        double singleTime = elapsedMicroseconds(start) / 1000.0;
+
+        start = chrono::steady_clock::now();
+        tessellateBatchCPU(curves, 0, curves.size(), EXPORT_SEGMENTS, threads, reference);
+        double parallelTime = elapsedMicroseconds(start) / 1000.0;
+
+        cout << setw(8) << count << fixed << setprecision(1) << setw(12) << singleTime << setw(10) << parallelTime
+             << setw(12) << reference.size() / parallelTime / 1000.0;
+        if (context == NULL) {
+            cout << defaultfloat << endl;
+            continue;
+        }
+
+        ComputeComparison comparison = { &reference, EXPORT_SEGMENTS + 1, 0.0f };
+        BatchTessellationStats stats;
+        /* Az első futás a meghajtó bemelegítése (shaderfordítás, pufferfoglalás). */
+        tessellateBatchGPU(curves, EXPORT_SEGMENTS, compareChunk, &comparison, stats);
+        comparison.maxDifference = 0.0f;
+        if (!tessellateBatchGPU(curves, EXPORT_SEGMENTS, compareChunk, &comparison, stats))
+            cerr << "compute shader tessellation failed" << endl;
+
+        double gpuTime = stats.uploadMs + stats.dispatchMs + stats.waitMs + stats.readbackMs;
+        cout << setw(10) << gpuTime << setw(11) << stats.uploadMs << setw(13) << stats.dispatchMs << setw(10) << stats.waitMs
+             << setw(13) << stats.readbackMs << setw(10) << stats.totalMs << setw(8) << stats.chunks << setw(12)
+             << reference.size() / gpuTime / 1000.0 << scientific << setprecision(2) << setw(12) << comparison.maxDifference
+             << defaultfloat << endl;
+    }
+
+    if (context != NULL) {
+        cleanUpComputeTessellation();
+        destroyComputeContext(context);
+    }
+    return EXIT_SUCCESS;
+}
+
+int runBenchmark(const char* name) {
+    if (strcmp(name, "cubic") == 0)
+        return benchmarkCubicApproximation();
+    if (strcmp(name, "vertex-formats") == 0)
+        return benchmarkVertexFormats();
+    if (strcmp(name, "patch") == 0)
+        return benchmarkPatchTessellation();
+    if (strcmp(name, "intersections") == 0)
+        return benchmarkIntersections();
+    if (strcmp(name, "simplify") == 0)
+        return benchmarkSimplification();
+    if (strcmp(name, "cache") == 0)
+        return benchmarkTessellationCache();
+    if (strcmp(name, "compute") == 0)
+        return benchmarkComputeTessellation();
+
+    cerr << "unknown benchmark: " << name << endl;
+    cerr << "available: cubic, vertex-formats, patch, intersections, simplify, cache, compute" << endl;
+    return EXIT_FAILURE;
+}
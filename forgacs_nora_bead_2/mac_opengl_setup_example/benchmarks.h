@@ -0,0 +1,14 @@
+//
+//  benchmarks.h
+//  mac_opengl_setup_example
+//
+//  Headless micro-benchmarks, run with --bench <name>.
+//
+
+#ifndef benchmarks_h
+#define benchmarks_h
+
+/* Returns the process exit code; prints the available names for an unknown one. */
+int runBenchmark(const char* name);
+
+#endif /* benchmarks_h */
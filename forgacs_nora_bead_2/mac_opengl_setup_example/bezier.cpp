@@ -0,0 +1,134 @@
+//
+//  bezier.cpp
+//  mac_opengl_setup_example
+//
+
+#include "bezier.h"
+
+#include <math.h>
+
+using namespace std;
+
+/*
+The definition of N choose R is to compute the two productsand divide one with the other,
+(N * (N - 1) * (N - 2) * ... * (N - R + 1)) / (1 * 2 * 3 * ... * R)
+However, the multiplications may become too large really quickand overflow existing data type.The implementation trick is to reorder the multiplicationand divisions as,
+👎 / 1 * (N - 1) / 2 * (N - 2) / 3 * ... * (N - R + 1) / R
+It's guaranteed that at each step the results is divisible (for n continuous numbers, one of them must be divisible by n, so is the product of these numbers).
+For example, for N choose 3, at least one of the N, N - 1, N - 2 will be a multiple of 3, and for N choose 4, at least one of N, N - 1, N - 2, N - 3 will be a multiple of 4.
+C++ code given below.
+*/
+int NCR(int n, int r) {
+    /*
+    binomial coefficient
+    */
+    if (r == 0) return 1;
+
+    /*
+     Extra computation saving for large R,
+     using property:
+     N choose R = N choose (N - R)
+    */
+    if (r > n / 2) return NCR(n, n - r);
+
+    long res = 1;
+
+    for (int k = 1; k <= r; ++k) {
+        res *= n - k + 1;
+        res /= k;
+    }
+
+    return res;
+}
+
+/*
+It will be the Bernstein basis polynomial of degree n.
+*/
+GLfloat blending(GLint n, GLint i, GLfloat t) {
+    return NCR(n, i) * pow(t, i) * pow(1.0f - t, n - i);
+}
+
+glm::vec3 evaluateBezier(const vector<glm::vec3>& controlPoints, GLfloat t) {
+    vector<glm::vec3> work(controlPoints);
+
+    for (GLint r = work.size() - 1; r > 0; r--)
+        for (GLint i = 0; i < r; i++)
+            work[i] = work[i] * (1.0f - t) + work[i + 1] * t;
+
+    return work[0];
+}
+
+void tessellateBezier(const vector<glm::vec3>& controlPoints, GLint segments, vector<glm::vec3>& out) {
+    /*
+    https://en.wikipedia.org/wiki/B%C3%A9zier_curve#Explicit_definition
+    */
+    GLint n = controlPoints.size() - 1;
+
+    if (controlPoints.empty() || segments < 1)
+        return;
+
+    /* Egész számú ciklusváltozó, hogy a t = 1 végpont lebegőpontos hiba miatt se maradjon ki. */
+    for (GLint s = 0; s <= segments; s++) {
+        GLfloat   t = (GLfloat)s / segments;
+        glm::vec3 nextPoint = glm::vec3(0.0f, 0.0f, 0.0f);
+
+        for (GLint i = 0; i <= n; i++) {
+            GLfloat B = blending(n, i, t);
+            nextPoint.x += B * controlPoints[i].x;
+            nextPoint.y += B * controlPoints[i].y;
+            nextPoint.z += B * controlPoints[i].z;
+        }
+
+        out.push_back(nextPoint);
+    }
+}
+
+void controlPointBounds(const vector<glm::vec3>& controlPoints, glm::vec2& outMin, glm::vec2& outMax) {
+    outMin = glm::vec2(INFINITY, INFINITY);
+    outMax = glm::vec2(-INFINITY, -INFINITY);
+
+    for (const glm::vec3& p : controlPoints) {
+        outMin = glm::min(outMin, glm::vec2(p.x, p.y));
+        outMax = glm::max(outMax, glm::vec2(p.x, p.y));
+    }
+}
+
+void subdivideBezier(const vector<glm::vec3>& controlPoints, GLfloat t,
+                     vector<glm::vec3>& outLeft, vector<glm::vec3>& outRight) {
+    vector<glm::vec3> work(controlPoints);
+    GLint n = controlPoints.size() - 1;
+
+    outLeft.resize(n + 1);
+    outRight.resize(n + 1);
+
+    /* A de Casteljau háromszög bal széle adja a bal, jobb széle a jobb fél kontrollpontjait. */
+    for (GLint r = 0; r <= n; r++) {
+        outLeft[r] = work[0];
+        outRight[n - r] = work[n - r];
+
+        for (GLint i = 0; i < n - r; i++)
+            work[i] = work[i] * (1.0f - t) + work[i + 1] * t;
+    }
+}
+
+void elevateDegree(vector<glm::vec3>& controlPoints) {
+    GLint n = controlPoints.size() - 1;
+    vector<glm::vec3> elevated(n + 2);
+
+    elevated[0] = controlPoints[0];
+    elevated[n + 1] = controlPoints[n];
+    for (GLint i = 1; i <= n; i++) {
+        GLfloat a = (GLfloat)i / (n + 1);
+        elevated[i] = controlPoints[i - 1] * a + controlPoints[i] * (1.0f - a);
+    }
+    controlPoints.swap(elevated);
+}
+
+GLfloat controlPolygonLength(const vector<glm::vec3>& controlPoints) {
+    GLfloat length = 0.0f;
+
+    for (size_t i = 1; i < controlPoints.size(); i++)
+        length += glm::length(glm::vec2(controlPoints[i].x - controlPoints[i - 1].x,
+                                        controlPoints[i].y - controlPoints[i - 1].y));
+    return length;
+}
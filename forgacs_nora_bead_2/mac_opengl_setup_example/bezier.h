@@ -0,0 +1,44 @@
+//
+//  bezier.h
+//  mac_opengl_setup_example
+//
+//  Bézier curve evaluation shared by the interactive editor and the replay tools.
+//
+
+#ifndef bezier_h
+#define bezier_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "cubic_approx.h"
+
+struct BezierCurve {
+    std::vector<glm::vec3> controlPoints;
+    CubicApproximation cubics;           // rendering/picking representation, rebuilt when controlPoints change
+};
+
+int NCR(int n, int r);
+GLfloat blending(GLint n, GLint i, GLfloat t);
+
+/* Single point of the curve (de Casteljau). */
+glm::vec3 evaluateBezier(const std::vector<glm::vec3>& controlPoints, GLfloat t);
+
+/* segments + 1 samples of the curve at t = 0, 1/segments, ..., 1 are appended to out. */
+void tessellateBezier(const std::vector<glm::vec3>& controlPoints, GLint segments, std::vector<glm::vec3>& out);
+
+/* Axis-aligned bounding box of the control polygon; by the convex hull property it contains the curve. */
+void controlPointBounds(const std::vector<glm::vec3>& controlPoints, glm::vec2& outMin, glm::vec2& outMax);
+
+/* de Casteljau split at t into two curves of the same degree. */
+void subdivideBezier(const std::vector<glm::vec3>& controlPoints, GLfloat t,
+                     std::vector<glm::vec3>& outLeft, std::vector<glm::vec3>& outRight);
+
+/* Raises the degree by one without changing the curve. */
+void elevateDegree(std::vector<glm::vec3>& controlPoints);
+
+/* Length of the control polygon, an upper bound of the arc length. */
+GLfloat controlPolygonLength(const std::vector<glm::vec3>& controlPoints);
+
+#endif /* bezier_h */
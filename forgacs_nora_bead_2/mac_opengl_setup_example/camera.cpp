@@ -0,0 +1,79 @@
+//
+//  camera.cpp
+//  mac_opengl_setup_example
+//
+
+#include "camera.h"
+#include "bezier.h"
+
+#include <math.h>
+
+using namespace std;
+
+glm::vec2 screenToWorld(const Camera& camera, double x, double y, int width, int height) {
+    GLfloat xNorm = x / (width / 2.0) - 1.0f;
+    GLfloat yNorm = (height - y) / (height / 2.0) - 1.0f;
+
+    return glm::vec2(xNorm, yNorm) / camera.zoom + camera.center;
+}
+
+GLfloat ndcToWorldLength(const Camera& camera, GLfloat length) {
+    return length / camera.zoom;
+}
+
+glm::mat4 viewMatrix(const Camera& camera) {
+    /* ndc = (world - center) * zoom */
+    glm::mat4 view = glm::mat4(1.0f);
+
+    view[0][0] = camera.zoom;
+    view[1][1] = camera.zoom;
+    view[3][0] = -camera.center.x * camera.zoom;
+    view[3][1] = -camera.center.y * camera.zoom;
+    return view;
+}
+
+void viewBounds(const Camera& camera, glm::vec2& outMin, glm::vec2& outMax) {
+    glm::vec2 halfExtent = glm::vec2(1.0f / camera.zoom, 1.0f / camera.zoom);
+
+    outMin = camera.center - halfExtent;
+    outMax = camera.center + halfExtent;
+}
+
+bool isBoxVisible(const Camera& camera, glm::vec2 boxMin, glm::vec2 boxMax) {
+    glm::vec2 viewMin, viewMax;
+    viewBounds(camera, viewMin, viewMax);
+
+    return boxMax.x >= viewMin.x && boxMin.x <= viewMax.x &&
+           boxMax.y >= viewMin.y && boxMin.y <= viewMax.y;
+}
+
+void zoomAt(Camera& camera, glm::vec2 anchor, GLfloat factor) {
+    GLfloat zoom = camera.zoom * factor;
+
+    if (zoom < CAMERA_MIN_ZOOM) zoom = CAMERA_MIN_ZOOM;
+    if (zoom > CAMERA_MAX_ZOOM) zoom = CAMERA_MAX_ZOOM;
+
+    /* anchor - center arányosan zsugorodik / nő, így a kurzor alatti pont helyben marad. */
+    camera.center = anchor - (anchor - camera.center) * (camera.zoom / zoom);
+    camera.zoom = zoom;
+}
+
+GLfloat pixelsPerWorldUnit(const Camera& camera, int width, int height) {
+    return camera.zoom * (width > height ? width : height) / 2.0f;
+}
+
+GLfloat worldToleranceForView(const Camera& camera, GLfloat pixels, int width, int height) {
+    GLfloat tolerance = pixels / pixelsPerWorldUnit(camera, width, height);
+
+    return exp2f(floorf(log2f(tolerance)));
+}
+
+GLint curveSegmentsForView(const Camera& camera, const vector<glm::vec3>& controlPoints, int width, int height) {
+    /* A kontrollpoligon hossza felülről becsüli a görbe hosszát; képernyőpixelre váltjuk. */
+    GLfloat lengthInPixels = controlPolygonLength(controlPoints) * pixelsPerWorldUnit(camera, width, height);
+    GLfloat segments = ceilf(lengthInPixels / LOD_PIXELS_PER_SEGMENT);
+
+    if (segments < LOD_MIN_SEGMENTS) return LOD_MIN_SEGMENTS;
+    if (segments > LOD_MAX_SEGMENTS) return LOD_MAX_SEGMENTS;
+    return (GLint)segments;
+}
@@ -0,0 +1,52 @@
+//
+//  camera.h
+//  mac_opengl_setup_example
+//
+//  2D pan/zoom camera, view culling and zoom-dependent tessellation level.
+//
+
+#ifndef camera_h
+#define camera_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/* zoom = 1 és center = (0, 0) esetén a világkoordináta megegyezik az NDC-vel. */
+struct Camera {
+    glm::vec2 center;
+    GLfloat zoom;
+};
+
+#define CAMERA_MIN_ZOOM 0.001f
+#define CAMERA_MAX_ZOOM 1000.0f
+
+/* Screen-space tessellation density: one curve segment per this many pixels of control polygon. */
+#define LOD_PIXELS_PER_SEGMENT 8.0f
+#define LOD_MIN_SEGMENTS 2
+#define LOD_MAX_SEGMENTS 256
+
+/* x, y are window coordinates with the origin in the top left corner, as GLFW reports them. */
+glm::vec2 screenToWorld(const Camera& camera, double x, double y, int width, int height);
+
+/* Converts a length given in NDC units (e.g. a picking radius) to world units. */
+GLfloat ndcToWorldLength(const Camera& camera, GLfloat length);
+
+glm::mat4 viewMatrix(const Camera& camera);
+
+void viewBounds(const Camera& camera, glm::vec2& outMin, glm::vec2& outMax);
+bool isBoxVisible(const Camera& camera, glm::vec2 boxMin, glm::vec2 boxMax);
+
+/* Keeps the world point under the cursor fixed while scaling the zoom by factor. */
+void zoomAt(Camera& camera, glm::vec2 anchor, GLfloat factor);
+
+GLfloat pixelsPerWorldUnit(const Camera& camera, int width, int height);
+
+/* A world-space error bound equivalent to the given number of pixels, rounded down to a power of two
+   so that small zoom changes do not invalidate tolerance-dependent caches. */
+GLfloat worldToleranceForView(const Camera& camera, GLfloat pixels, int width, int height);
+
+/* Number of segments that gives roughly LOD_PIXELS_PER_SEGMENT pixel long segments on screen. */
+GLint curveSegmentsForView(const Camera& camera, const std::vector<glm::vec3>& controlPoints, int width, int height);
+
+#endif /* camera_h */
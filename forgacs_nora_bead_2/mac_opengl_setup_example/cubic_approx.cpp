@@ -0,0 +1,160 @@
+//
+//  cubic_approx.cpp
+//  mac_opengl_setup_example
+//
+
+#include "cubic_approx.h"
+#include "bezier.h"
+
+#include <math.h>
+
+using namespace std;
+
+/*
+Fokszámcsökkentés: a köbös darab a végpontokat és a végponti deriváltakat őrzi meg,
+C0 = P0, C1 = P0 + n/3 (P1 - P0), C2 = Pn - n/3 (Pn - Pn-1), C3 = Pn.
+Mivel a felezéskor keletkező két fél a csatlakozásnál azonos deriválttal indul, a darabok C1 folytonosan illeszkednek.
+*/
+static void reduceToCubic(const vector<glm::vec3>& p, glm::vec3* outCubic) {
+    GLint   n = p.size() - 1;
+    GLfloat k = n / 3.0f;
+
+    outCubic[0] = p[0];
+    outCubic[1] = p[0] + (p[1] - p[0]) * k;
+    outCubic[2] = p[n] - (p[n] - p[n - 1]) * k;
+    outCubic[3] = p[n];
+}
+
+/*
+A hibakorlát: a köbös darabot n-edfokúra emelve a két kontrollpoligon pontonkénti különbsége maga is egy Bézier-görbe
+kontrollpoligonja, és a konvex burok tulajdonság miatt ennek legnagyobb hossza felülről becsüli az eltérést.
+*/
+static GLfloat reductionError(const vector<glm::vec3>& p, const glm::vec3* cubic) {
+    vector<glm::vec3> elevated(cubic, cubic + 4);
+    GLint n = p.size() - 1;
+
+    while ((GLint)elevated.size() - 1 < n)
+        elevateDegree(elevated);
+
+    GLfloat error = 0.0f;
+    for (GLint i = 0; i <= n; i++)
+        error = fmaxf(error, glm::length(p[i] - elevated[i]));
+    return error;
+}
+
+static GLfloat approximateRange(const vector<glm::vec3>& p, GLfloat tolerance, GLfloat t0, GLfloat t1, GLint depth,
+                                vector<glm::vec3>& outPieces, vector<GLfloat>& outKnots) {
+    glm::vec3 cubic[4];
+    GLfloat   error = 0.0f;
+
+    if (p.size() <= 4) {
+        /* Legfeljebb harmadfokú görbe pontosan felírható köbösként. */
+        vector<glm::vec3> elevated(p);
+        while (elevated.size() < 4)
+            elevateDegree(elevated);
+        copy(elevated.begin(), elevated.end(), cubic);
+    }
+    else {
+        reduceToCubic(p, cubic);
+        error = reductionError(p, cubic);
+
+        if (error > tolerance && depth < CUBIC_MAX_DEPTH) {
+            vector<glm::vec3> left, right;
+            GLfloat tm = (t0 + t1) / 2.0f;
+
+            subdivideBezier(p, 0.5f, left, right);
+            GLfloat leftError = approximateRange(left, tolerance, t0, tm, depth + 1, outPieces, outKnots);
+            GLfloat rightError = approximateRange(right, tolerance, tm, t1, depth + 1, outPieces, outKnots);
+            return fmaxf(leftError, rightError);
+        }
+    }
+
+    outPieces.insert(outPieces.end(), cubic, cubic + 4);
+    outKnots.push_back(t1);
+    return error;
+}
+
+GLfloat approximateWithCubics(const vector<glm::vec3>& controlPoints, GLfloat tolerance,
+                              vector<glm::vec3>& outPieces, vector<GLfloat>& outKnots) {
+    outPieces.clear();
+    outKnots.clear();
+
+    if (controlPoints.empty())
+        return 0.0f;
+
+    outKnots.push_back(0.0f);
+    return approximateRange(controlPoints, tolerance, 0.0f, 1.0f, 0, outPieces, outKnots);
+}
+
+bool updateCubicApproximation(CubicApproximation& approx, const vector<glm::vec3>& controlPoints, GLfloat tolerance) {
+    /* A túl finom eredményt is eldobjuk (pl. nagy nagyítás után kicsinyítve), különben feleslegesen sok darabot rajzolnánk. */
+    bool accurate = approx.tolerance <= tolerance && approx.tolerance * 16.0f >= tolerance;
+
+    if (accurate && approx.source == controlPoints)
+        return false;
+
+    approx.source = controlPoints;
+    approx.tolerance = tolerance;
+    approx.error = approximateWithCubics(controlPoints, tolerance, approx.pieces, approx.knots);
+    return true;
+}
+
+static GLfloat pieceLength(const glm::vec3* piece) {
+    return glm::length(piece[1] - piece[0]) + glm::length(piece[2] - piece[1]) + glm::length(piece[3] - piece[2]);
+}
+
+glm::vec3 evaluateCubic(const glm::vec3* piece, GLfloat t) {
+    GLfloat s = 1.0f - t;
+
+    return piece[0] * (s * s * s) + piece[1] * (3.0f * s * s * t) + piece[2] * (3.0f * s * t * t) + piece[3] * (t * t * t);
+}
+
+void tessellateCubics(const vector<glm::vec3>& pieces, GLint segments, vector<glm::vec3>& out) {
+    GLint   pieceCount = pieces.size() / 4;
+    GLfloat totalLength = 0.0f;
+
+    if (pieceCount == 0)
+        return;
+
+    for (GLint k = 0; k < pieceCount; k++)
+        totalLength += pieceLength(&pieces[4 * k]);
+
+    out.push_back(pieces[0]);
+    for (GLint k = 0; k < pieceCount; k++) {
+        const glm::vec3* piece = &pieces[4 * k];
+        GLfloat length = pieceLength(piece);
+        GLint   pieceSegments = totalLength > 0.0f ? (GLint)ceilf(segments * length / totalLength) : 1;
+
+        if (pieceSegments < 1)
+            pieceSegments = 1;
+
+        /* A darab kezdőpontja az előző darab végpontja, azt nem ismételjük meg. */
+        for (GLint s = 1; s <= pieceSegments; s++)
+            out.push_back(evaluateCubic(piece, (GLfloat)s / pieceSegments));
+    }
+}
+
+static GLfloat distanceToSegment(glm::vec2 P, glm::vec2 A, glm::vec2 B) {
+    glm::vec2 AB = B - A;
+    GLfloat   len2 = glm::dot(AB, AB);
+    GLfloat   t = len2 > 0.0f ? glm::clamp(glm::dot(P - A, AB) / len2, 0.0f, 1.0f) : 0.0f;
+
+    return glm::length(P - (A + AB * t));
+}
+
+GLfloat distanceToCubics(const vector<glm::vec3>& pieces, glm::vec2 P, GLint samplesPerPiece) {
+    GLint   pieceCount = pieces.size() / 4;
+    GLfloat best = INFINITY;
+
+    for (GLint k = 0; k < pieceCount; k++) {
+        const glm::vec3* piece = &pieces[4 * k];
+        glm::vec3 previous = piece[0];
+
+        for (GLint s = 1; s <= samplesPerPiece; s++) {
+            glm::vec3 next = evaluateCubic(piece, (GLfloat)s / samplesPerPiece);
+            best = fminf(best, distanceToSegment(P, glm::vec2(previous.x, previous.y), glm::vec2(next.x, next.y)));
+            previous = next;
+        }
+    }
+    return best;
+}
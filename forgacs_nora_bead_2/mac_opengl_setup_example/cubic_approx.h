@@ -0,0 +1,46 @@
+//
+//  cubic_approx.h
+//  mac_opengl_setup_example
+//
+//  Approximation of a degree-n Bézier curve by a chain of cubic pieces, used for rendering and
+//  picking. The exact control points stay in BezierCurve for export.
+//
+
+#ifndef cubic_approx_h
+#define cubic_approx_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#define CUBIC_MAX_DEPTH 16
+
+/* A megjelenítéshez használt közelítés megengedett eltérése a pontos görbétől, képernyőpixelben. */
+#define CUBIC_PIXEL_TOLERANCE 0.25f
+
+struct CubicApproximation {
+    std::vector<glm::vec3> source;     // control points the pieces were built from
+    GLfloat tolerance = 0.0f;          // requested error bound
+    GLfloat error = 0.0f;              // guaranteed error bound of the result
+    std::vector<glm::vec3> pieces;     // 4 control points per cubic piece
+    std::vector<GLfloat> knots;        // parameter of the exact curve at each piece boundary (pieces + 1 values)
+};
+
+/* Subdivision + degree reduction. Returns an upper bound of the parametric distance between the
+   exact curve and the cubic pieces (max distance of the difference control polygon). */
+GLfloat approximateWithCubics(const std::vector<glm::vec3>& controlPoints, GLfloat tolerance,
+                              std::vector<glm::vec3>& outPieces, std::vector<GLfloat>& outKnots);
+
+/* Rebuilds the approximation only if the control points changed or the cached result is not
+   accurate enough (or is needlessly fine). Returns true if it was rebuilt. */
+bool updateCubicApproximation(CubicApproximation& approx, const std::vector<glm::vec3>& controlPoints, GLfloat tolerance);
+
+glm::vec3 evaluateCubic(const glm::vec3* piece, GLfloat t);
+
+/* Approximately segments + 1 points along the piece chain, distributed by control polygon length. */
+void tessellateCubics(const std::vector<glm::vec3>& pieces, GLint segments, std::vector<glm::vec3>& out);
+
+/* Distance of P from the piece chain, measured on a polyline of samplesPerPiece segments per piece. */
+GLfloat distanceToCubics(const std::vector<glm::vec3>& pieces, glm::vec2 P, GLint samplesPerPiece);
+
+#endif /* cubic_approx_h */
@@ -0,0 +1,163 @@
+//
+//  export.cpp
+//  mac_opengl_setup_example
+//
+
+#include "export.h"
+#include "batch_tessellation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <math.h>
+#include <thread>
+
+using namespace std;
+
+/* Egy megnyitott SVG fájl és a hozzá tartozó számlálók; a görbék darabonként érkeznek bele. */
+struct SVGWriter {
+    ofstream out;
+    const vector<BezierCurve>* curves;
+    GLfloat tolerance;
+    SimplifyMethod method;
+    ExportStats* stats;
+};
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static bool openSVG(SVGWriter& writer, const char* path, const vector<BezierCurve>& curves, GLfloat tolerance,
+                    SimplifyMethod method, ExportStats& outStats) {
+    writer.out.open(path, ios::out | ios::trunc);
+    if (!writer.out.is_open()) {
+        cerr << "error opening export file for writing: " << path << endl;
+        return false;
+    }
+    /* Az alapértelmezett 6 értékes jegy 1000 körüli koordinátáknál már 1e-3 kerekítés, akkora, mint a tűrés;
+       a float max_digits10 jegye visszaolvasva pontosan ugyanazt az értéket adja. */
+    writer.out.precision(numeric_limits<GLfloat>::max_digits10);
+    writer.curves = &curves;
+    writer.tolerance = tolerance;
+    writer.method = method;
+    writer.stats = &outStats;
+    outStats = ExportStats();
+    outStats.threads = max(1u, thread::hardware_concurrency());
+
+    /* A görbe a kontrollpoligon konvex burkában van, így a viewBox a minták előtt is kiírható. */
+    glm::vec2 boxMin = glm::vec2(INFINITY, INFINITY), boxMax = glm::vec2(-INFINITY, -INFINITY);
+    for (const BezierCurve& curve : curves) {
+        if (curve.controlPoints.size() < 2)
+            continue;
+        glm::vec2 curveMin, curveMax;
+        controlPointBounds(curve.controlPoints, curveMin, curveMax);
+        boxMin = glm::min(boxMin, curveMin);
+        boxMax = glm::max(boxMax, curveMax);
+    }
+    if (boxMin.x > boxMax.x)
+        boxMin = boxMax = glm::vec2(0.0f);
+
+    /* Az SVG y tengelye lefelé mutat, ezért az y koordinátákat tükrözzük. */
+    writer.out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"" << boxMin.x << " " << -boxMax.y << " "
+               << boxMax.x - boxMin.x << " " << boxMax.y - boxMin.y << "\">\n";
+    return true;
+}
+
+/*
+A [firstCurve, firstCurve + curveCount) görbék mintái (görbénként EXPORT_SEGMENTS + 1): egyszerűsítés és kiírás.
+Az eltolások a darabon belüliek, így a simplifyRanges GLint tartománykezdetei egy darabnyi mintán nem csordulnak túl.
+*/
+static void writeCurves(SVGWriter& writer, size_t firstCurve, size_t curveCount, const vector<glm::vec3>& samples) {
+    const size_t samplesPerCurve = EXPORT_SEGMENTS + 1;
+    ExportStats& stats = *writer.stats;
+    vector<GLint> firsts;
+    vector<GLsizei> counts;
+
+    static_assert((size_t)EXPORT_CHUNK_CURVES * (EXPORT_SEGMENTS + 1) <= (size_t)INT32_MAX, "chunk offsets must fit in GLint");
+    static_assert((size_t)COMPUTE_CHUNK_CURVES * (EXPORT_SEGMENTS + 1) <= (size_t)INT32_MAX, "chunk offsets must fit in GLint");
+
+    for (size_t c = 0; c < curveCount; c++)
+        if ((*writer.curves)[firstCurve + c].controlPoints.size() >= 2) {
+            firsts.push_back((GLint)(c * samplesPerCurve));
+            counts.push_back(samplesPerCurve);
+        }
+
+    vector<unsigned char> keep;
+    auto start = chrono::steady_clock::now();
+    simplifyRanges(samples, firsts, counts, writer.tolerance, writer.method, stats.threads, keep);
+    stats.simplifyMs += elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    stats.curves += firsts.size();
+    stats.tessellatedVertices += firsts.size() * samplesPerCurve;
+    for (size_t i = 0; i < firsts.size(); i++) {
+        size_t first = firsts[i], last = first + counts[i];
+
+        writer.out << "<polyline fill=\"none\" stroke=\"black\" vector-effect=\"non-scaling-stroke\" points=\"";
+        for (size_t v = first; v < last; v++)
+            if (keep[v]) {
+                writer.out << samples[v].x << "," << -samples[v].y << " ";
+                stats.exportedVertices++;
+            }
+        writer.out << "\"/>\n";
+    }
+    stats.writeMs += elapsedMs(start);
+}
+
+static bool closeSVG(SVGWriter& writer) {
+    writer.out << "</svg>\n";
+    writer.stats->fileBytes = writer.out.tellp();
+    return writer.out.good();
+}
+
+bool exportSceneSVG(const char* path, const vector<BezierCurve>& curves, GLfloat tolerance, SimplifyMethod method,
+                    ExportStats& outStats) {
+    SVGWriter writer;
+    if (!openSVG(writer, path, curves, tolerance, method, outStats))
+        return false;
+
+    /* Darabonként, ugyanúgy, mint a compute shaderes út: a memória egy darabnyi mintára korlátos. */
+    vector<glm::vec3> samples;
+    auto start = chrono::steady_clock::now();
+    for (size_t first = 0; first < curves.size(); first += EXPORT_CHUNK_CURVES) {
+        size_t count = min((size_t)EXPORT_CHUNK_CURVES, curves.size() - first);
+
+        auto tessellateStart = chrono::steady_clock::now();
+        tessellateBatchCPU(curves, first, count, EXPORT_SEGMENTS, outStats.threads, samples);
+        outStats.tessellateMs += elapsedMs(tessellateStart);
+
+        writeCurves(writer, first, count, samples);
+    }
+
+    bool written = closeSVG(writer);
+    outStats.totalMs = elapsedMs(start);
+    return written;
+}
+
+static void writeChunk(size_t firstCurve, size_t curveCount, const vector<glm::vec3>& samples, void* user) {
+    writeCurves(*(SVGWriter*)user, firstCurve, curveCount, samples);
+}
+
+bool exportSceneSVGCompute(const char* path, const vector<BezierCurve>& curves, GLfloat tolerance,
+                           SimplifyMethod method, ExportStats& outStats) {
+    SVGWriter writer;
+    if (!openSVG(writer, path, curves, tolerance, method, outStats))
+        return false;
+
+    BatchTessellationStats batchStats;
+    auto start = chrono::steady_clock::now();
+    outStats.gpu = true;
+    if (!tessellateBatchGPU(curves, EXPORT_SEGMENTS, writeChunk, &writer, batchStats)) {
+        cerr << "compute shader tessellation failed" << endl;
+        return false;
+    }
+    /* Csak a tesszelálás saját, külön mért szakaszai; a kiírás és az egyszerűsítés a saját mezőjébe került. */
+    outStats.tessellateMs = batchStats.uploadMs + batchStats.dispatchMs + batchStats.waitMs + batchStats.readbackMs;
+
+    bool written = closeSVG(writer);
+    outStats.totalMs = elapsedMs(start);
+    return written;
+}
@@ -0,0 +1,52 @@
+//
+//  export.h
+//  mac_opengl_setup_example
+//
+//  Batch export of the scene as SVG polylines, run with --export <file>. The curves are tessellated
+//  either on all CPU threads or by the compute shader of batch_tessellation (--export-backend gpu).
+//
+
+#ifndef export_h
+#define export_h
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+#include "bezier.h"
+#include "simplify.h"
+
+/* Görbénként 101 minta, az eredeti fix felbontás; az egyszerűsítés ebből hagy el pontokat. */
+#define EXPORT_SEGMENTS 100
+
+/* Az exportált töröttvonal legnagyobb eltérése a mintáktól, világkoordinátában (--export-tolerance). */
+#define EXPORT_TOLERANCE 1e-3f
+
+/* A CPU-s export is ennyi görbénként tesszelál és ír, így a minták egyszerre legfeljebb ~19 MiB-ot foglalnak
+   (a compute shader darabjai is legfeljebb ekkorák). */
+#define EXPORT_CHUNK_CURVES 16384
+
+struct ExportStats {
+    size_t curves;
+    size_t tessellatedVertices;
+    size_t exportedVertices;
+    size_t fileBytes;
+    double tessellateMs;   // CPU: tessellateBatchCPU; GPU: upload, dispatch, waiting and readback of tessellateBatchGPU
+    double simplifyMs;
+    double writeMs;        // formatting the polylines into the file
+    double totalMs;        // wall clock of the whole export; on the GPU the phases overlap
+    unsigned threads;
+    bool gpu;
+};
+
+/* Tessellates the curves exactly, EXPORT_CHUNK_CURVES at a time, simplifies them split between all hardware threads
+   and writes the polylines as SVG. */
+bool exportSceneSVG(const char* path, const std::vector<BezierCurve>& curves, GLfloat tolerance, SimplifyMethod method,
+                    ExportStats& outStats);
+
+/* Same output, but the samples come from tessellateBatchGPU chunk by chunk and each chunk is simplified and
+   written while the GPU works on the next ones. Needs initComputeTessellation on the current context. */
+bool exportSceneSVGCompute(const char* path, const std::vector<BezierCurve>& curves, GLfloat tolerance,
+                           SimplifyMethod method, ExportStats& outStats);
+
+#endif /* export_h */
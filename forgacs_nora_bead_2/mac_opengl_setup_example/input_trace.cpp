@@ -0,0 +1,192 @@
+//
+//  input_trace.cpp
+//  mac_opengl_setup_example
+//
+//  Trace file format, one event per line:
+//      c <time> <x> <y>                              cursor position
+//      b <time> <button> <action> <mods> <x> <y>     mouse button
+//      s <time> <width> <height>                     framebuffer size
+//      w <time> <xoffset> <yoffset> <x> <y>          scroll wheel
+//      k <time> <key> <action> <mods> <x> <y>        keyboard
+//  Lines starting with '#' are comments. The first line is the "# bezier input trace v<n>" header:
+//  v2 added the w and k records. Older recorders already wrote them under a v1 header, so both
+//  versions are read the same way; newer versions are rejected.
+//
+
+#include "input_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+/* A rögzítés mindig a legújabb formátumot írja; a betöltés minden korábbit elfogad. */
+#define INPUT_TRACE_VERSION 2
+
+static const char traceHeader[] = "# bezier input trace v";
+
+static ofstream traceOut;
+
+bool startInputRecording(const char* path)
+{
+    traceOut.open(path, ios::out | ios::trunc);
+    if (!traceOut.is_open()) {
+        cerr << "error opening input trace for writing: " << path << endl;
+        return false;
+    }
+
+    /* A double értékeket veszteségmentesen írjuk ki, hogy a visszajátszás bitre azonos legyen. */
+    traceOut << setprecision(17);
+    traceOut << traceHeader << INPUT_TRACE_VERSION << endl;
+    return true;
+}
+
+bool isRecordingInput()
+{
+    return traceOut.is_open();
+}
+
+void recordInputEvent(const InputEvent& event)
+{
+    if (!traceOut.is_open())
+        return;
+
+    switch (event.type) {
+        case INPUT_CURSOR_POS:
+            traceOut << "c " << event.time << " " << event.x << " " << event.y << "\n";
+            break;
+        case INPUT_MOUSE_BUTTON:
+            traceOut << "b " << event.time << " " << event.button << " " << event.action << " " << event.mods
+                     << " " << event.x << " " << event.y << "\n";
+            break;
+        case INPUT_FRAMEBUFFER_SIZE:
+            traceOut << "s " << event.time << " " << event.x << " " << event.y << "\n";
+            break;
+        case INPUT_SCROLL:
+            traceOut << "w " << event.time << " " << event.dx << " " << event.dy << " " << event.x << " " << event.y << "\n";
+            break;
+        case INPUT_KEY:
+            traceOut << "k " << event.time << " " << event.key << " " << event.action << " " << event.mods
+                     << " " << event.x << " " << event.y << "\n";
+            break;
+    }
+}
+
+void stopInputRecording()
+{
+    if (traceOut.is_open())
+        traceOut.close();
+}
+
+bool loadInputTrace(const char* path, vector<InputEvent>& outEvents)
+{
+    ifstream traceIn(path, ios::in);
+    if (!traceIn.is_open()) {
+        cerr << "error opening input trace: " << path << endl;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(traceIn, line)) {
+        lineNumber++;
+        if (line.compare(0, sizeof(traceHeader) - 1, traceHeader) == 0) {
+            int version = atoi(line.c_str() + sizeof(traceHeader) - 1);
+            if (version < 1 || version > INPUT_TRACE_VERSION) {
+                cerr << "unsupported input trace version: " << line << endl;
+                return false;
+            }
+            continue;
+        }
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        istringstream fields(line);
+        char kind = 0;
+        InputEvent event = {};
+        fields >> kind >> event.time;
+
+        switch (kind) {
+            case 'c':
+                event.type = INPUT_CURSOR_POS;
+                fields >> event.x >> event.y;
+                break;
+            case 'b':
+                event.type = INPUT_MOUSE_BUTTON;
+                fields >> event.button >> event.action >> event.mods >> event.x >> event.y;
+                break;
+            case 's':
+                event.type = INPUT_FRAMEBUFFER_SIZE;
+                fields >> event.x >> event.y;
+                break;
+            case 'w':
+                event.type = INPUT_SCROLL;
+                fields >> event.dx >> event.dy >> event.x >> event.y;
+                break;
+            case 'k':
+                event.type = INPUT_KEY;
+                fields >> event.key >> event.action >> event.mods >> event.x >> event.y;
+                break;
+            default:
+                fields.setstate(ios::failbit);
+                break;
+        }
+
+        if (fields.fail()) {
+            cerr << "malformed input trace line " << lineNumber << ": " << line << endl;
+            return false;
+        }
+        outEvents.push_back(event);
+    }
+
+    return true;
+}
+
+/* Nearest-rank percentile of an already sorted sample. */
+static double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.5);
+    rank = min(max(rank, (size_t)1), sorted.size());
+    return sorted[rank - 1];
+}
+
+bool replayInputTrace(const char* path, InputEventHandler handler, ReplayStats& outStats)
+{
+    vector<InputEvent> events;
+    if (!loadInputTrace(path, events))
+        return false;
+
+    vector<double> latencies;
+    latencies.reserve(events.size());
+
+    for (const InputEvent& event : events) {
+        auto start = chrono::steady_clock::now();
+        bool producedGeometry = handler(event);
+        auto end = chrono::steady_clock::now();
+
+        if (producedGeometry)
+            latencies.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+
+    sort(latencies.begin(), latencies.end());
+
+    outStats.events = events.size();
+    outStats.geometryEvents = latencies.size();
+    outStats.p50Ms = percentile(latencies, 50.0);
+    outStats.p99Ms = percentile(latencies, 99.0);
+    outStats.maxMs = latencies.empty() ? 0.0 : latencies.back();
+    outStats.totalMs = 0.0;
+    for (double latency : latencies)
+        outStats.totalMs += latency;
+
+    return true;
+}
@@ -0,0 +1,55 @@
+//
+//  input_trace.h
+//  mac_opengl_setup_example
+//
+//  Recording of the GLFW input callback stream and its headless replay.
+//
+
+#ifndef input_trace_h
+#define input_trace_h
+
+#include <cstddef>
+#include <vector>
+
+enum InputEventType {
+    INPUT_CURSOR_POS = 0,
+    INPUT_MOUSE_BUTTON = 1,
+    INPUT_FRAMEBUFFER_SIZE = 2,
+    INPUT_SCROLL = 3,
+    INPUT_KEY = 4,
+};
+
+/* Egy rögzített bemeneti esemény: a callback paraméterei időbélyeggel együtt. */
+struct InputEvent {
+    InputEventType type;
+    double time;        // glfwGetTime() at the moment the callback fired
+    double x, y;        // cursor position in window coordinates, or width/height for a resize
+    int button, action, mods;
+    int key;
+    double dx, dy;      // scroll offsets
+};
+
+/* Handler called for every replayed event; returns true if the event produced new geometry. */
+typedef bool (*InputEventHandler)(const InputEvent& event);
+
+struct ReplayStats {
+    size_t events;           // all events in the trace
+    size_t geometryEvents;   // events that rebuilt the curve
+    double p50Ms;
+    double p99Ms;
+    double maxMs;
+    double totalMs;
+};
+
+bool startInputRecording(const char* path);
+bool isRecordingInput();
+void recordInputEvent(const InputEvent& event);
+void stopInputRecording();
+
+bool loadInputTrace(const char* path, std::vector<InputEvent>& outEvents);
+
+/* Feeds the trace to the handler as fast as possible (no sleeping between events, no window)
+   and measures event-to-geometry-ready latency for the events that rebuilt the curve. */
+bool replayInputTrace(const char* path, InputEventHandler handler, ReplayStats& outStats);
+
+#endif /* input_trace_h */
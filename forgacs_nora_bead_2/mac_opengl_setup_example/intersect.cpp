@@ -0,0 +1,511 @@
+//
+//  intersect.cpp
+//  mac_opengl_setup_example
+//
+
+#include "intersect.h"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+/* A float paraméter ennél keskenyebb tartományt már nem tud értelmesen tovább szűkíteni. */
+#define PARAMETER_EPSILON 1e-6f
+
+/* Egy görbe darabja a [t0, t1] paramétertartományon, saját kontrollpontjaival. */
+struct CurvePiece {
+    vector<glm::vec3> points;
+    GLfloat t0, t1;
+};
+
+/* Egy metszéshez konvergáló vágás eredménye, mindkét görbén a maradék tartománnyal. */
+struct ClipLeaf {
+    GLfloat s0, s1, t0, t1;
+    GLfloat s, t;
+    GLfloat residual;
+    bool unfinished;        // the step budget ran out before the piece shrank below tolerance
+};
+
+struct ClipContext {
+    GLfloat tolerance;
+    size_t steps;
+    IntersectionStats* stats;
+    vector<ClipLeaf> leaves;
+    bool exhausted;
+};
+
+static bool boxesOverlap(glm::vec2 minA, glm::vec2 maxA, glm::vec2 minB, glm::vec2 maxB, GLfloat slack) {
+    return minA.x <= maxB.x + slack && minB.x <= maxA.x + slack && minA.y <= maxB.y + slack && minB.y <= maxA.y + slack;
+}
+
+static GLfloat boxSize(glm::vec2 boxMin, glm::vec2 boxMax) {
+    return fmaxf(boxMax.x - boxMin.x, boxMax.y - boxMin.y);
+}
+
+/* Point and first derivative at t (de Casteljau down to two points). */
+static glm::vec2 evaluateWithDerivative(const vector<glm::vec3>& controlPoints, GLfloat t, glm::vec2& outDerivative) {
+    vector<glm::vec3> work(controlPoints);
+    GLint n = controlPoints.size() - 1;
+
+    for (GLint r = n; r > 1; r--)
+        for (GLint i = 0; i < r; i++)
+            work[i] = work[i] * (1.0f - t) + work[i + 1] * t;
+
+    outDerivative = glm::vec2(work[1] - work[0]) * (GLfloat)n;
+    return glm::vec2(work[0] * (1.0f - t) + work[1] * t);
+}
+
+/*
+A távolságfüggvény d(t) maga is Bézier-polinom (i/n, d_i) kontrollpontokkal, így a konvex burka tartalmazza.
+Azt a [lo, hi] tartományt keressük, ahol a burok belemetsz a [dMin, dMax] sávba: a burok határa a kontrollpontok
+közötti szakaszokból áll, ezért elég a sávba eső pontokat és a szakaszok sávhatárokkal vett metszéspontjait nézni.
+*/
+static bool clipToBand(const vector<GLfloat>& d, GLfloat dMin, GLfloat dMax, GLfloat& outLo, GLfloat& outHi) {
+    GLint n = d.size() - 1;
+
+    outLo = INFINITY;
+    outHi = -INFINITY;
+    for (GLint i = 0; i <= n; i++) {
+        GLfloat xi = (GLfloat)i / n;
+
+        if (d[i] >= dMin && d[i] <= dMax) {
+            outLo = fminf(outLo, xi);
+            outHi = fmaxf(outHi, xi);
+        }
+        for (GLint j = i + 1; j <= n; j++) {
+            if (d[i] == d[j])
+                continue;
+
+            GLfloat xj = (GLfloat)j / n;
+            GLfloat edges[2] = { dMin, dMax };
+            for (GLfloat edge : edges) {
+                GLfloat u = (edge - d[i]) / (d[j] - d[i]);
+                if (u >= 0.0f && u <= 1.0f) {
+                    outLo = fminf(outLo, xi + u * (xj - xi));
+                    outHi = fmaxf(outHi, xi + u * (xj - xi));
+                }
+            }
+        }
+    }
+    return outLo <= outHi;
+}
+
+/* Signed distances of the control points from the line through origin with unit normal. */
+static void lineDistances(const vector<glm::vec3>& controlPoints, glm::vec2 origin, glm::vec2 normal, vector<GLfloat>& out) {
+    out.resize(controlPoints.size());
+    for (size_t i = 0; i < controlPoints.size(); i++)
+        out[i] = glm::dot(glm::vec2(controlPoints[i]) - origin, normal);
+}
+
+/*
+Vastag egyenes: a másik darab végpontjain átmenő egyenes, a kontrollpontjai által kifeszített sávval. Visszatérési érték:
+-1 ha a piece biztosan nem metszi (el is dobható), 0 ha a vastag egyenes nem használható (elfajult húr), 1 ha vágtunk.
+*/
+static int fatLineClip(const vector<glm::vec3>& piece, const vector<glm::vec3>& other, GLfloat slack,
+                       GLfloat& outLo, GLfloat& outHi) {
+    glm::vec2 origin = glm::vec2(other.front());
+    glm::vec2 chord = glm::vec2(other.back()) - origin;
+
+    /* Zárt vagy pontra zsugorodott darabnál a legtávolabbi kontrollpont felé mutató húrt használjuk. */
+    if (glm::dot(chord, chord) <= slack * slack) {
+        GLfloat farthest = 0.0f;
+        for (const glm::vec3& p : other)
+            if (glm::dot(glm::vec2(p) - origin, glm::vec2(p) - origin) > farthest) {
+                chord = glm::vec2(p) - origin;
+                farthest = glm::dot(chord, chord);
+            }
+        if (farthest <= slack * slack)
+            return 0;
+    }
+
+    glm::vec2 normal = glm::vec2(-chord.y, chord.x) / glm::length(chord);
+    vector<GLfloat> d;
+
+    lineDistances(other, origin, normal, d);
+    GLfloat dMin = *min_element(d.begin(), d.end()) - slack;
+    GLfloat dMax = *max_element(d.begin(), d.end()) + slack;
+
+    lineDistances(piece, origin, normal, d);
+    return clipToBand(d, dMin, dMax, outLo, outHi) ? 1 : -1;
+}
+
+/* Keeps the [lo, hi] part of the piece (in its own parameter). */
+static void restrictPiece(CurvePiece& piece, GLfloat lo, GLfloat hi) {
+    vector<glm::vec3> left, right;
+    GLfloat span = piece.t1 - piece.t0;
+
+    if (hi < 1.0f) {
+        subdivideBezier(piece.points, hi, left, right);
+        piece.points.swap(left);
+    }
+    if (lo > 0.0f) {
+        subdivideBezier(piece.points, lo / hi, left, right);
+        piece.points.swap(right);
+    }
+    piece.t1 = piece.t0 + span * hi;
+    piece.t0 = piece.t0 + span * lo;
+}
+
+static void halvePiece(const CurvePiece& piece, CurvePiece& outLeft, CurvePiece& outRight) {
+    GLfloat tm = (piece.t0 + piece.t1) / 2.0f;
+
+    subdivideBezier(piece.points, 0.5f, outLeft.points, outRight.points);
+    outLeft.t0 = piece.t0;
+    outLeft.t1 = tm;
+    outRight.t0 = tm;
+    outRight.t1 = piece.t1;
+}
+
+/* Newton lépések az A(s) = B(t) egyenletre a teljes görbéken; a vágás által hagyott tartományban kell maradnia. */
+static void polishCurveIntersection(const vector<glm::vec3>& a, const vector<glm::vec3>& b, ClipLeaf& leaf) {
+    glm::vec2 dA, dB;
+    GLfloat s = leaf.s, t = leaf.t;
+    GLfloat spanS = leaf.s1 - leaf.s0, spanT = leaf.t1 - leaf.t0;
+
+    leaf.residual = glm::length(evaluateWithDerivative(a, s, dA) - evaluateWithDerivative(b, t, dB));
+    for (int iteration = 0; iteration < 3; iteration++) {
+        glm::vec2 F = evaluateWithDerivative(a, s, dA) - evaluateWithDerivative(b, t, dB);
+        GLfloat det = dB.x * dA.y - dA.x * dB.y;
+        if (fabsf(det) < 1e-12f)
+            break;
+
+        s += (F.x * dB.y - dB.x * F.y) / det;
+        t += (F.x * dA.y - dA.x * F.y) / det;
+        if (s < leaf.s0 - spanS || s > leaf.s1 + spanS || t < leaf.t0 - spanT || t > leaf.t1 + spanT)
+            break;
+
+        /* A maradékot a görbén belülre szorított paraméterekkel mérjük, mert azokat adjuk vissza. */
+        s = fminf(fmaxf(s, 0.0f), 1.0f);
+        t = fminf(fmaxf(t, 0.0f), 1.0f);
+        GLfloat residual = glm::length(evaluateWithDerivative(a, s, dA) - evaluateWithDerivative(b, t, dB));
+        if (residual >= leaf.residual)
+            break;
+        leaf.s = s;
+        leaf.t = t;
+        leaf.residual = residual;
+    }
+}
+
+static void clipCurves(CurvePiece a, CurvePiece b, ClipContext& context) {
+    GLfloat slack = 0.25f * context.tolerance;
+
+    for (;;) {
+        glm::vec2 minA, maxA, minB, maxB;
+        controlPointBounds(a.points, minA, maxA);
+        controlPointBounds(b.points, minB, maxB);
+        if (!boxesOverlap(minA, maxA, minB, maxB, slack))
+            return;
+
+        GLfloat sizeA = boxSize(minA, maxA), sizeB = boxSize(minB, maxB);
+        bool doneA = sizeA <= context.tolerance || a.t1 - a.t0 <= PARAMETER_EPSILON;
+        bool doneB = sizeB <= context.tolerance || b.t1 - b.t0 <= PARAMETER_EPSILON;
+        if (doneA && doneB) {
+            ClipLeaf leaf = { a.t0, a.t1, b.t0, b.t1, (a.t0 + a.t1) / 2.0f, (b.t0 + b.t1) / 2.0f, 0.0f };
+            context.leaves.push_back(leaf);
+            return;
+        }
+
+        /* Elfogyott a lépéskeret: a darabpárt befejezetlen levélként adjuk tovább (a többi ágat is), és a
+           Newton-lépések döntik el, van-e benne metszés. */
+        if (context.steps++ >= INTERSECT_MAX_STEPS) {
+            ClipLeaf leaf = { a.t0, a.t1, b.t0, b.t1, (a.t0 + a.t1) / 2.0f, (b.t0 + b.t1) / 2.0f, 0.0f, true };
+            context.leaves.push_back(leaf);
+            context.exhausted = true;
+            return;
+        }
+
+        /* Mindig a nagyobbik darabot vágjuk a kisebbik vastag egyenesével. */
+        bool clipA = !doneA && (doneB || sizeA >= sizeB);
+        CurvePiece& piece = clipA ? a : b;
+        const CurvePiece& other = clipA ? b : a;
+
+        GLfloat lo = 0.0f, hi = 1.0f;
+        int clipped = fatLineClip(piece.points, other.points, slack, lo, hi);
+        if (clipped < 0)
+            return;
+
+        if (clipped == 0 || hi - lo > 1.0f - INTERSECT_MIN_CLIP) {
+            /* Több metszés vagy érintés: a vágás nem halad, felezzük a darabot, és mindkét felét külön követjük. */
+            CurvePiece left, right;
+            halvePiece(piece, left, right);
+            if (context.stats != NULL)
+                context.stats->splits++;
+            if (clipA) {
+                clipCurves(left, b, context);
+                clipCurves(right, b, context);
+            }
+            else {
+                clipCurves(a, left, context);
+                clipCurves(a, right, context);
+            }
+            return;
+        }
+
+        restrictPiece(piece, lo, hi);
+        if (context.stats != NULL)
+            context.stats->clips++;
+    }
+}
+
+static bool intervalsTouch(GLfloat lo0, GLfloat hi0, GLfloat lo1, GLfloat hi1) {
+    return lo1 <= hi0 + PARAMETER_EPSILON && lo0 <= hi1 + PARAMETER_EPSILON;
+}
+
+/*
+Egy metszés több szomszédos levélben is megjelenhet (felezési határon vagy érintésnél). Két levél ugyanaz a metszés,
+ha a tartományaik összeérnek, vagy ha a két görbe a köztük lévő paraméterfelezőben is tolerancián belül van egymáshoz
+(érintő, majdnem párhuzamos szakasz). Az összevont csoportot a legkisebb maradékú levél képviseli.
+*/
+static void mergeLeaves(vector<ClipLeaf>& leaves, const vector<glm::vec3>& a, const vector<glm::vec3>& b,
+                        GLfloat tolerance, vector<glm::vec2>& outParams) {
+    sort(leaves.begin(), leaves.end(), [](const ClipLeaf& x, const ClipLeaf& y) { return x.s0 < y.s0; });
+
+    vector<ClipLeaf> merged;
+    for (const ClipLeaf& leaf : leaves) {
+        if (!merged.empty()) {
+            ClipLeaf& last = merged.back();
+            bool touching = intervalsTouch(last.s0, last.s1, leaf.s0, leaf.s1) && intervalsTouch(last.t0, last.t1, leaf.t0, leaf.t1);
+            bool coincident = glm::length(glm::vec2(evaluateBezier(a, (last.s + leaf.s) / 2.0f)
+                                                    - evaluateBezier(b, (last.t + leaf.t) / 2.0f))) <= tolerance;
+
+            if (touching || coincident) {
+                if (leaf.residual < last.residual) {
+                    last.s = leaf.s;
+                    last.t = leaf.t;
+                    last.residual = leaf.residual;
+                }
+                last.s1 = fmaxf(last.s1, leaf.s1);
+                last.t0 = fminf(last.t0, leaf.t0);
+                last.t1 = fmaxf(last.t1, leaf.t1);
+                continue;
+            }
+        }
+        merged.push_back(leaf);
+    }
+
+    for (const ClipLeaf& leaf : merged)
+        outParams.push_back(glm::vec2(leaf.s, leaf.t));
+}
+
+/*
+A jelenet távoli részein a koordináták nagyok (a float lépésköze 100 körül ~1e-5), ezért a vágást az egyik görbe
+kezdőpontjába tolt, helyi koordinátákban végezzük; így a tolerancia a jelenet méretétől függetlenül elérhető.
+*/
+static vector<glm::vec3> translated(const vector<glm::vec3>& controlPoints, glm::vec3 origin) {
+    vector<glm::vec3> local(controlPoints);
+
+    for (glm::vec3& p : local)
+        p = p - origin;
+    return local;
+}
+
+void intersectCurves(const vector<glm::vec3>& worldA, const vector<glm::vec3>& worldB, GLfloat tolerance,
+                     vector<glm::vec2>& outParams, IntersectionStats* stats) {
+    outParams.clear();
+    if (worldA.size() < 2 || worldB.size() < 2)
+        return;
+
+    vector<glm::vec3> a = translated(worldA, worldA.front());
+    vector<glm::vec3> b = translated(worldB, worldA.front());
+
+    ClipContext context = { tolerance, 0, stats, {} };
+    CurvePiece pieceA = { a, 0.0f, 1.0f };
+    CurvePiece pieceB = { b, 0.0f, 1.0f };
+
+    clipCurves(pieceA, pieceB, context);
+    for (ClipLeaf& leaf : context.leaves)
+        polishCurveIntersection(a, b, leaf);
+
+    /* A befejezetlen darabokból csak az számít metszésnek, amelyiket a Newton-lépések tolerancián belülre vittek. */
+    context.leaves.erase(remove_if(context.leaves.begin(), context.leaves.end(), [&](const ClipLeaf& leaf) {
+        return leaf.unfinished && leaf.residual > tolerance;
+    }), context.leaves.end());
+    if (context.exhausted && stats != NULL)
+        stats->exhausted++;
+    mergeLeaves(context.leaves, a, b, tolerance, outParams);
+}
+
+/* A szakasz egyenesére a vágás egy nulla vastagságú (tolerancianyi) sávval történik. */
+static void clipCurveAgainstLine(CurvePiece piece, glm::vec2 p0, glm::vec2 p1, glm::vec2 normal, ClipContext& context) {
+    GLfloat slack = 0.25f * context.tolerance;
+    glm::vec2 segmentMin = glm::min(p0, p1), segmentMax = glm::max(p0, p1);
+    vector<GLfloat> d;
+
+    for (;;) {
+        glm::vec2 pieceMin, pieceMax;
+        controlPointBounds(piece.points, pieceMin, pieceMax);
+        if (!boxesOverlap(pieceMin, pieceMax, segmentMin, segmentMax, slack))
+            return;
+
+        if (boxSize(pieceMin, pieceMax) <= context.tolerance || piece.t1 - piece.t0 <= PARAMETER_EPSILON) {
+            ClipLeaf leaf = { piece.t0, piece.t1, 0.0f, 1.0f, (piece.t0 + piece.t1) / 2.0f, 0.0f, 0.0f };
+            context.leaves.push_back(leaf);
+            return;
+        }
+
+        if (context.steps++ >= INTERSECT_MAX_STEPS) {
+            ClipLeaf leaf = { piece.t0, piece.t1, 0.0f, 1.0f, (piece.t0 + piece.t1) / 2.0f, 0.0f, 0.0f, true };
+            context.leaves.push_back(leaf);
+            context.exhausted = true;
+            return;
+        }
+
+        GLfloat lo, hi;
+        lineDistances(piece.points, p0, normal, d);
+        if (!clipToBand(d, -slack, slack, lo, hi))
+            return;
+
+        if (hi - lo > 1.0f - INTERSECT_MIN_CLIP) {
+            CurvePiece left, right;
+            halvePiece(piece, left, right);
+            if (context.stats != NULL)
+                context.stats->splits++;
+            clipCurveAgainstLine(left, p0, p1, normal, context);
+            clipCurveAgainstLine(right, p0, p1, normal, context);
+            return;
+        }
+
+        restrictPiece(piece, lo, hi);
+        if (context.stats != NULL)
+            context.stats->clips++;
+    }
+}
+
+void intersectCurveSegment(const vector<glm::vec3>& worldPoints, glm::vec2 worldP0, glm::vec2 worldP1, GLfloat tolerance,
+                           vector<glm::vec2>& outParams, IntersectionStats* stats) {
+    outParams.clear();
+
+    glm::vec2 direction = worldP1 - worldP0;
+    GLfloat length = glm::length(direction);
+    if (worldPoints.size() < 2 || length <= tolerance)
+        return;
+
+    vector<glm::vec3> controlPoints = translated(worldPoints, worldPoints.front());
+    glm::vec2 p0 = worldP0 - glm::vec2(worldPoints.front()), p1 = worldP1 - glm::vec2(worldPoints.front());
+
+    glm::vec2 normal = glm::vec2(-direction.y, direction.x) / length;
+    ClipContext context = { tolerance, 0, stats, {} };
+    CurvePiece piece = { controlPoints, 0.0f, 1.0f };
+    clipCurveAgainstLine(piece, p0, p1, normal, context);
+    if (context.exhausted && stats != NULL)
+        stats->exhausted++;
+
+    vector<ClipLeaf> hits;
+    for (ClipLeaf leaf : context.leaves) {
+        /* Newton lépések a d(t) = 0 egyenletre, majd a szakasz paramétere vetítéssel. */
+        glm::vec2 derivative;
+        GLfloat t = leaf.s;
+        for (int iteration = 0; iteration < 3; iteration++) {
+            GLfloat distance = glm::dot(evaluateWithDerivative(controlPoints, t, derivative) - p0, normal);
+            GLfloat slope = glm::dot(derivative, normal);
+            if (fabsf(slope) < 1e-12f)
+                break;
+
+            GLfloat next = t - distance / slope;
+            if (next < leaf.s0 - (leaf.s1 - leaf.s0) || next > leaf.s1 + (leaf.s1 - leaf.s0))
+                break;
+            t = fminf(fmaxf(next, 0.0f), 1.0f);
+        }
+
+        glm::vec2 point = evaluateWithDerivative(controlPoints, t, derivative);
+        GLfloat s = glm::dot(point - p0, direction) / (length * length);
+        if (s < -tolerance / length || s > 1.0f + tolerance / length)
+            continue;
+
+        leaf.s = t;
+        leaf.t = fminf(fmaxf(s, 0.0f), 1.0f);
+        leaf.t0 = leaf.t1 = leaf.t;
+        leaf.residual = fabsf(glm::dot(point - p0, normal));
+        if (leaf.unfinished && leaf.residual > tolerance)
+            continue;
+        hits.push_back(leaf);
+    }
+    vector<glm::vec3> segment = { glm::vec3(p0, 0.0f), glm::vec3(p1, 0.0f) };
+    mergeLeaves(hits, controlPoints, segment, tolerance, outParams);
+}
+
+struct CurveBox {
+    GLint curve;
+    glm::vec2 boxMin, boxMax;
+};
+
+void findCandidatePairs(const vector<BezierCurve>& curves, GLfloat tolerance, vector<pair<GLint, GLint>>& outPairs) {
+    vector<CurveBox> boxes;
+
+    outPairs.clear();
+    boxes.reserve(curves.size());
+    for (size_t i = 0; i < curves.size(); i++) {
+        if (curves[i].controlPoints.size() < 2)
+            continue;
+
+        CurveBox box;
+        box.curve = i;
+        controlPointBounds(curves[i].controlPoints, box.boxMin, box.boxMax);
+        boxes.push_back(box);
+    }
+
+    /* Sort and sweep: x szerint rendezve csak azokat a dobozokat kell megnézni, amelyek még az aktuális x-tartományba esnek. */
+    sort(boxes.begin(), boxes.end(), [](const CurveBox& x, const CurveBox& y) { return x.boxMin.x < y.boxMin.x; });
+    for (size_t i = 0; i < boxes.size(); i++)
+        for (size_t j = i + 1; j < boxes.size() && boxes[j].boxMin.x <= boxes[i].boxMax.x + tolerance; j++) {
+            if (boxes[j].boxMin.y > boxes[i].boxMax.y + tolerance || boxes[i].boxMin.y > boxes[j].boxMax.y + tolerance)
+                continue;
+            outPairs.push_back(make_pair(min(boxes[i].curve, boxes[j].curve), max(boxes[i].curve, boxes[j].curve)));
+        }
+}
+
+void findSceneIntersections(const vector<BezierCurve>& curves, GLfloat tolerance,
+                            vector<CurveIntersection>& out, IntersectionStats* stats) {
+    vector<pair<GLint, GLint>> pairs;
+    vector<glm::vec2> params;
+
+    out.clear();
+    findCandidatePairs(curves, tolerance, pairs);
+    if (stats != NULL)
+        stats->candidatePairs += pairs.size();
+
+    for (const pair<GLint, GLint>& candidate : pairs) {
+        const vector<glm::vec3>& a = curves[candidate.first].controlPoints;
+        intersectCurves(a, curves[candidate.second].controlPoints, tolerance, params, stats);
+
+        for (const glm::vec2& param : params) {
+            CurveIntersection hit = { candidate.first, candidate.second, param.x, param.y, glm::vec2(evaluateBezier(a, param.x)) };
+            out.push_back(hit);
+        }
+    }
+
+    sort(out.begin(), out.end(), [](const CurveIntersection& x, const CurveIntersection& y) {
+        if (x.curveA != y.curveA)
+            return x.curveA < y.curveA;
+        if (x.curveB != y.curveB)
+            return x.curveB < y.curveB;
+        return x.tA < y.tA;
+    });
+}
+
+void findSegmentIntersections(const vector<BezierCurve>& curves, glm::vec2 p0, glm::vec2 p1, GLfloat tolerance,
+                              vector<SegmentIntersection>& out, IntersectionStats* stats) {
+    glm::vec2 segmentMin = glm::min(p0, p1), segmentMax = glm::max(p0, p1);
+    vector<glm::vec2> params;
+
+    out.clear();
+    for (size_t i = 0; i < curves.size(); i++) {
+        const vector<glm::vec3>& controlPoints = curves[i].controlPoints;
+        if (controlPoints.size() < 2)
+            continue;
+
+        glm::vec2 curveMin, curveMax;
+        controlPointBounds(controlPoints, curveMin, curveMax);
+        if (!boxesOverlap(curveMin, curveMax, segmentMin, segmentMax, tolerance))
+            continue;
+        if (stats != NULL)
+            stats->candidatePairs++;
+
+        intersectCurveSegment(controlPoints, p0, p1, tolerance, params, stats);
+        for (const glm::vec2& param : params) {
+            SegmentIntersection hit = { (GLint)i, param.x, param.y, p0 + (p1 - p0) * param.y };
+            out.push_back(hit);
+        }
+    }
+}
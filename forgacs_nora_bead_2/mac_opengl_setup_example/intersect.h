@@ -0,0 +1,70 @@
+//
+//  intersect.h
+//  mac_opengl_setup_example
+//
+//  Curve–curve and curve–segment intersections computed on the control polygons (Bézier clipping
+//  with bounding box rejection), with a sort-and-sweep broad phase over the whole scene.
+//
+
+#ifndef intersect_h
+#define intersect_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+#include "bezier.h"
+
+/* Alapértelmezett pontosság világkoordinátában: az ennél kisebb darabokon megáll a vágás. */
+#define INTERSECT_TOLERANCE 1e-5f
+
+/* Ha a vágás a paramétertartománynak ennél kisebb részét vágja le, inkább megfelezzük a darabot. */
+#define INTERSECT_MIN_CLIP 0.2f
+
+/* Görbepáronként legfeljebb ennyi vágási/felezési lépés (érintő metszéseknél a vágás nem konvergál); utána a
+   megmaradt darabokat Newton-lépésekkel zárjuk le, és az IntersectionStats::exhausted számolja az ilyen párokat. */
+#define INTERSECT_MAX_STEPS 4096
+
+struct CurveIntersection {
+    GLint curveA, curveB;    // curveA < curveB
+    GLfloat tA, tB;
+    glm::vec2 point;
+};
+
+struct SegmentIntersection {
+    GLint curve;
+    GLfloat t;               // parameter on the curve
+    GLfloat s;               // parameter on the segment, 0 at p0 and 1 at p1
+    glm::vec2 point;
+};
+
+struct IntersectionStats {
+    size_t candidatePairs = 0;   // curve pairs (or curves for a segment) left by the broad phase
+    size_t clips = 0;            // fat line clipping steps
+    size_t splits = 0;           // halvings when a clip did not shrink the interval enough
+    size_t exhausted = 0;        // pairs (or curves) that hit INTERSECT_MAX_STEPS; their unfinished pieces were
+                                 // polished with Newton steps and kept only if they converged within tolerance
+};
+
+/* Parameter pairs (tA, tB) where the two curves meet, within tolerance in world units. */
+void intersectCurves(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b, GLfloat tolerance,
+                     std::vector<glm::vec2>& outParams, IntersectionStats* stats = NULL);
+
+/* Parameter pairs (t, s) where the curve crosses the segment p0-p1. */
+void intersectCurveSegment(const std::vector<glm::vec3>& controlPoints, glm::vec2 p0, glm::vec2 p1, GLfloat tolerance,
+                           std::vector<glm::vec2>& outParams, IntersectionStats* stats = NULL);
+
+/* Broad phase only: pairs of curves whose control point bounding boxes overlap (sort and sweep on x). */
+void findCandidatePairs(const std::vector<BezierCurve>& curves, GLfloat tolerance,
+                        std::vector<std::pair<GLint, GLint>>& outPairs);
+
+/* All intersections between different curves of the scene. Self-intersections are not reported. */
+void findSceneIntersections(const std::vector<BezierCurve>& curves, GLfloat tolerance,
+                            std::vector<CurveIntersection>& out, IntersectionStats* stats = NULL);
+
+/* Curves crossed by the segment p0-p1 (selection by a lasso line, trimming). */
+void findSegmentIntersections(const std::vector<BezierCurve>& curves, glm::vec2 p0, glm::vec2 p1, GLfloat tolerance,
+                              std::vector<SegmentIntersection>& out, IntersectionStats* stats = NULL);
+
+#endif /* intersect_h */
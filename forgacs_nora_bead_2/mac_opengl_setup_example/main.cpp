@@ -1,30 +1,63 @@
 #include <array>
+#include <chrono>
 #include <fstream>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <cstring>
 #include <math.h>
+#include <random>
+#include <thread>
 #include <string>
 #include <vector>
 
+#include "batch_tessellation.h"
+#include "benchmarks.h"
+#include "bezier.h"
+#include "camera.h"
+#include "export.h"
+#include "input_trace.h"
+#include "intersect.h"
+#include "patch.h"
+#include "tessellation_cache.h"
+#include "tessellation_worker.h"
+
 using namespace std;
 
 int        window_width = 600;
 int        window_height = 600;
 char    window_title[] = "Bezier curve";
 
-std::vector<glm::vec3> pointToDraw;
 GLint dragged = -1;
 
-std::vector<glm::vec3> myControlPoints = {
-    glm::vec3(-0.5f, -0.5f, 0.0f),
-    glm::vec3(-0.5f,  0.5f, 0.0f),
-    glm::vec3(0.5f, -0.5f, 0.0f),
-    glm::vec3(0.5f,  0.5f, 0.0f),
-    //glm::vec3(-1.0f,  1.0f, 0.0f),
-
+/* --replay módban nincs ablak, az OpenGL hívásokat kihagyjuk. */
+bool headless = false;
+
+std::vector<BezierCurve> curves = {
+    { {
+        glm::vec3(-0.5f, -0.5f, 0.0f),
+        glm::vec3(-0.5f,  0.5f, 0.0f),
+        glm::vec3(0.5f, -0.5f, 0.0f),
+        glm::vec3(0.5f,  0.5f, 0.0f),
+        //glm::vec3(-1.0f,  1.0f, 0.0f),
+    } },
 };
+GLint activeCurve = 0;
+
+Camera camera = { glm::vec2(0.0f, 0.0f), 1.0f };
+bool panning = false;
+glm::vec2 panAnchor;
+
+/* Egy görgetési lépés ennyivel szorozza a nagyítást. */
+#define ZOOM_STEP 1.1f
+
+/* Mennyire volt elavult a kirajzolt geometria (a tesszelálás a háttérszálon fut). */
+uint64_t displayedFrames = 0;
+uint64_t staleFrames = 0;
+uint64_t maxEditsBehind = 0;
+double   maxLatencyMs = 0.0;
 
 /* Vertex buffer objektum és vertex array objektum az adattároláshoz.*/
 #define numVBOs 1
@@ -33,6 +66,28 @@ GLuint VBO[numVBOs];
 GLuint VAO[numVAOs];
 
 GLuint renderingProgram;
+GLint viewLocation;
+GLint quantizedLocation;
+
+/* int16 vertexeknél a görbénkénti kvantálási dobozok és a keresőtáblák, buffer textúraként a vertex shadernek
+   (dobozok, tartománykezdetek, blokkok; a 0., 1. és 2. textúraegységen). */
+GLuint quantizationBuffers[3];
+GLuint quantizationTextures[3];
+
+/* A kért vertex formátum, és amelyikre a VAO éppen be van állítva (a half-float visszaeshet float2-re). */
+VertexFormat vertexFormat = VERTEX_FLOAT2;
+VertexFormat vboFormat = VERTEX_FLOAT3;
+SimplifyMethod simplifyMethod = SIMPLIFY_DOUGLAS_PEUCKER;
+uint64_t uploadCount = 0;
+uint64_t uploadedBytes = 0;
+
+/* --patch <fokszám>: egy felületdarab drótvázát is kirajzoljuk, egyik kontrollpontját mozgatva. */
+#define PATCH_RESOLUTION 64
+bool showPatch = false;
+BezierPatch patch;
+PatchTessellation patchTessellation;
+GLuint patchVAO, patchVBO, patchIBO;
+GLsizei patchIndexCount = 0;
 
 bool checkOpenGLError() {
     bool foundError = false;
@@ -167,140 +222,165 @@ GLfloat dist2(glm::vec3 P1, glm::vec3 P2) {
     return dx * dx + dy * dy;
 }
 
-GLint getActivePoint(vector<glm::vec3> p, GLfloat sensitivity, GLfloat x, GLfloat y) {
-    GLfloat        s = sensitivity * sensitivity;
+/* P világkoordinátában adott; a sensitivity NDC-ben, hogy nagyítástól függetlenül ugyanakkora legyen a képernyőn. */
+GLint getActivePoint(const vector<glm::vec3>& p, GLfloat sensitivity, glm::vec2 P) {
+    GLfloat        s = ndcToWorldLength(camera, sensitivity);
     GLint        size = p.size();
-    GLfloat        xNorm = x / (window_width / 2) - 1.0f;
-    GLfloat        yNorm = y / (window_height / 2) - 1.0f;
-    glm::vec3    P = glm::vec3(xNorm, yNorm, 0.0f);
 
+    s = s * s;
     for (GLint i = 0; i < size; i++)
-        if (dist2(p[i], P) < s)
+        if (dist2(p[i], glm::vec3(P, 0.0f)) < s)
             return i;
 
     return -1;
 }
 
-/*
-The definition of N choose R is to compute the two productsand divide one with the other,
-(N * (N - 1) * (N - 2) * ... * (N - R + 1)) / (1 * 2 * 3 * ... * R)
-However, the multiplications may become too large really quickand overflow existing data type.The implementation trick is to reorder the multiplicationand divisions as,
-👎 / 1 * (N - 1) / 2 * (N - 2) / 3 * ... * (N - R + 1) / R
-It's guaranteed that at each step the results is divisible (for n continuous numbers, one of them must be divisible by n, so is the product of these numbers).
-For example, for N choose 3, at least one of the N, N - 1, N - 2 will be a multiple of 3, and for N choose 4, at least one of N, N - 1, N - 2, N - 3 will be a multiple of 4.
-C++ code given below.
-*/
-int NCR(int n, int r) {
-    /*
-    binomial coefficient
-    */
-    if (r == 0) return 1;
-
-    /*
-     Extra computation saving for large R,
-     using property:
-     N choose R = N choose (N - R)
-    */
-    if (r > n / 2) return NCR(n, n - r);
-
-    long res = 1;
-
-    for (int k = 1; k <= r; ++k) {
-        res *= n - k + 1;
-        res /= k;
-    }
-
-    return res;
-}
-
-/*
-It will be the Bernstein basis polynomial of degree n.
-*/
-GLfloat blending(GLint n, GLint i, GLfloat t) {
-    return NCR(n, i) * pow(t, i) * pow(1.0f - t, n - i);
-}
-
-void drawBezierCurve(std::vector<glm::vec3> controlPoints) {
-    /*
-    https://en.wikipedia.org/wiki/B%C3%A9zier_curve#Explicit_definition
-    */
-    glm::vec3    nextPoint;
-    GLfloat        t = 0.0f, B;
-    GLfloat        increment = 1.0f / 100.0f; /* hány darab szakaszból rakjuk össze a görbénket? */
-
-    while (t <= 1.0f) {
-        nextPoint = glm::vec3(0.0f, 0.0f, 0.0f);
-        for (int i = 0; i < controlPoints.size(); i++) {
-            B = blending(controlPoints.size() - 1, i, t);
-            nextPoint.x += B * controlPoints.at(i).x;
-            nextPoint.y += B * controlPoints.at(i).y;
-            nextPoint.z += B * controlPoints.at(i).z;
-        }
+/* Az aktív görbét nézzük meg először, utána a többit, hogy egymást fedő pontoknál a szerkesztett görbe nyerjen. */
+bool pickControlPoint(glm::vec2 P, GLint& outCurve, GLint& outIndex) {
+    GLint count = curves.size();
 
-        pointToDraw.push_back(nextPoint);
-        t += increment;
-    }
-    for (int i = 0; i < controlPoints.size(); i++)
-    {
-        pointToDraw.push_back(controlPoints[i]);
+    for (GLint k = 0; k < count; k++) {
+        GLint c = (activeCurve + k) % count;
+        GLint i = getActivePoint(curves[c].controlPoints, 0.1f, P);
+
+        if (i != -1) {
+            outCurve = c;
+            outIndex = i;
+            return true;
+        }
     }
-    
+    return false;
 }
 
-void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+/* A jelenet minden módosítását elküldjük a tesszeláló szálnak is, az a saját másolatán alkalmazza őket. */
+void postPointEdit(SceneEditType type, GLint curve, GLint index, glm::vec3 point) {
+    SceneEdit edit = {};
+    edit.type = type;
+    edit.curve = curve;
+    edit.index = index;
+    edit.point = point;
+    postSceneEdit(edit);
 }
 
-void cursorPosCallback(GLFWwindow* window, double xPos, double yPos) {
-    if (dragged >= 0) {
-        GLfloat    xNorm = xPos / (window_width / 2) - 1.0f;
-        GLfloat    yNorm = (window_height - yPos) / (window_height / 2) - 1.0f;
+/* A nézet változása (pásztázás, nagyítás, átméretezés) a láthatóságot és az LOD-ot érinti. */
+void postViewEdit() {
+    SceneEdit edit = {};
+    edit.type = EDIT_SET_VIEW;
+    edit.camera = camera;
+    edit.width = window_width;
+    edit.height = window_height;
+    postSceneEdit(edit);
+}
 
-        myControlPoints.at(dragged).x = xNorm;
-        myControlPoints.at(dragged).y = yNorm;
+/* Feltölti a kész geometriát a VBO-ba. Headless visszajátszásnál nincs OpenGL kontextus. */
+void updateVBO(const GeometryFrame& frame) {
+    if (headless)
+        return;
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-        glBufferData(GL_ARRAY_BUFFER, pointToDraw.size() * sizeof(glm::vec3), pointToDraw.data(), GL_STATIC_DRAW);
-        
-        pointToDraw.clear();
-        drawBezierCurve(myControlPoints);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, frame.packed.size(), frame.packed.data(), GL_STATIC_DRAW);
+    uploadedBytes += frame.packed.size();
+
+    if (frame.format == VERTEX_INT16) {
+        const void* data[3] = { frame.quantization.data(), frame.quantizationFirsts.data(), frame.quantizationBlocks.data() };
+        size_t sizes[3] = { frame.quantization.size() * sizeof(glm::vec4), frame.quantizationFirsts.size() * sizeof(GLint),
+                            frame.quantizationBlocks.size() * sizeof(GLint) };
+        for (int i = 0; i < 3; i++) {
+            glBindBuffer(GL_TEXTURE_BUFFER, quantizationBuffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, sizes[i], data[i], GL_STATIC_DRAW);
+            uploadedBytes += sizes[i];
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
     }
+
+    if (frame.format != vboFormat) {
+        glBindVertexArray(VAO[0]);
+        setVertexAttribFormat(frame.format);
+        glBindVertexArray(0);
+        vboFormat = frame.format;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    uploadCount++;
 }
 
-//void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-//    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-//        double    x, y;
-//
-//        glfwGetCursorPos(window, &x, &y);
-//        dragged = getActivePoint(myControlPoints, 0.1f, x, window_height - y);
-//    }
-//
-//    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
-//        dragged = -1;
-//
-//}
-void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-    double x, y;
-    glfwGetCursorPos(window, &x, &y);
+/* A kurzorhoz legközelebbi látható görbe a köbös közelítés alapján, vagy -1, ha egyik sincs sensitivity távolságon belül. */
+GLint pickCurve(glm::vec2 P, GLfloat sensitivity) {
+    GLfloat s = ndcToWorldLength(camera, sensitivity);
+    GLfloat best = s;
+    GLint   picked = -1;
+    GLfloat tolerance = worldToleranceForView(camera, CUBIC_PIXEL_TOLERANCE, window_width, window_height);
 
-    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-        // Try to drag an existing point
-        dragged = getActivePoint(myControlPoints, 0.1f, x, window_height - y);
+    for (GLint c = 0; c < curves.size(); c++) {
+        glm::vec2 boxMin, boxMax;
 
-        // If no point selected, add new point
-        if (dragged == -1) {
-            GLfloat xNorm = x / (window_width / 2) - 1.0f;
-            GLfloat yNorm = (window_height - y) / (window_height / 2) - 1.0f;
+        if (curves[c].controlPoints.empty())
+            continue;
 
-            myControlPoints.push_back(glm::vec3(xNorm, yNorm, 0.0f));
+        controlPointBounds(curves[c].controlPoints, boxMin, boxMax);
+        if (P.x < boxMin.x - s || P.x > boxMax.x + s || P.y < boxMin.y - s || P.y > boxMax.y + s)
+            continue;
+
+        /* A rajzoló példány a worker szálon él, itt csak a jelöltekhez készítjük el (vagy vesszük a gyorsítótárból) a közelítést. */
+        updateCubicApproximation(curves[c].cubics, curves[c].controlPoints, tolerance);
+
+        GLfloat d = distanceToCubics(curves[c].cubics.pieces, P, 16);
+        if (d < best) {
+            best = d;
+            picked = c;
         }
+    }
+    return picked;
+}
 
-        // Update curve and buffer
-        pointToDraw.clear();
-        drawBezierCurve(myControlPoints);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-        glBufferData(GL_ARRAY_BUFFER, pointToDraw.size() * sizeof(glm::vec3), pointToDraw.data(), GL_STATIC_DRAW);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+/* Az input kezelők window nélkül is hívhatók, így a rögzített eseményfolyam visszajátszható.
+   Visszatérési érték: küldtünk-e a geometriát érintő módosítást a tesszeláló szálnak. */
+bool handleCursorPos(double xPos, double yPos) {
+    glm::vec2 P = screenToWorld(camera, xPos, yPos, window_width, window_height);
+
+    if (panning) {
+        /* A megfogott világpont maradjon a kurzor alatt. */
+        camera.center += panAnchor - P;
+        postViewEdit();
+        return true;
+    }
+
+    if (dragged >= 0) {
+        curves[activeCurve].controlPoints.at(dragged).x = P.x;
+        curves[activeCurve].controlPoints.at(dragged).y = P.y;
+
+        postPointEdit(EDIT_SET_POINT, activeCurve, dragged, curves[activeCurve].controlPoints[dragged]);
+        return true;
+    }
+    return false;
+}
+
+bool handleMouseButton(int button, int action, int mods, double x, double y) {
+    glm::vec2 P = screenToWorld(camera, x, y, window_width, window_height);
+    bool rebuilt = false;
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS && (mods & GLFW_MOD_SHIFT)) {
+        // Shift + click selects the curve under the cursor as the active one
+        GLint curve = pickCurve(P, 0.05f);
+        if (curve != -1)
+            activeCurve = curve;
+    }
+    else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+        // Try to drag an existing point
+        GLint curve, index;
+        if (pickControlPoint(P, curve, index)) {
+            activeCurve = curve;
+            dragged = index;
+        }
+        else {
+            // If no point selected, add new point
+            curves[activeCurve].controlPoints.push_back(glm::vec3(P, 0.0f));
+            dragged = -1;
+
+            // Update curve and buffer
+            postPointEdit(EDIT_ADD_POINT, activeCurve, -1, glm::vec3(P, 0.0f));
+            rebuilt = true;
+        }
     }
 
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE) {
@@ -308,44 +388,326 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     }
 
     if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
-        GLint indexToRemove = getActivePoint(myControlPoints, 0.1f, x, window_height - y);
-        if (indexToRemove != -1) {
-            myControlPoints.erase(myControlPoints.begin() + indexToRemove);
+        GLint curve, index;
+        if (pickControlPoint(P, curve, index)) {
+            curves[curve].controlPoints.erase(curves[curve].controlPoints.begin() + index);
 
             // Recompute curve
-            pointToDraw.clear();
-            drawBezierCurve(myControlPoints);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-            glBufferData(GL_ARRAY_BUFFER, pointToDraw.size() * sizeof(glm::vec3), pointToDraw.data(), GL_STATIC_DRAW);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            postPointEdit(EDIT_REMOVE_POINT, curve, index, glm::vec3(0.0f));
+            rebuilt = true;
         }
     }
+
+    // Middle button drags the view
+    if (button == GLFW_MOUSE_BUTTON_MIDDLE && action == GLFW_PRESS) {
+        panning = true;
+        panAnchor = P;
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_MIDDLE && action == GLFW_RELEASE) {
+        panning = false;
+    }
+
+    return rebuilt;
 }
 
+bool handleScroll(double xOffset, double yOffset, double x, double y) {
+    glm::vec2 anchor = screenToWorld(camera, x, y, window_width, window_height);
 
-void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    zoomAt(camera, anchor, powf(ZOOM_STEP, (GLfloat)yOffset));
+    postViewEdit();
+    return true;
+}
+
+bool handleKey(int key, int action, int mods) {
+    if (action != GLFW_PRESS)
+        return false;
+
+    switch (key) {
+        case GLFW_KEY_N:
+            // Start a new curve; the next left click places its first point
+            curves.push_back(BezierCurve());
+            activeCurve = curves.size() - 1;
+            dragged = -1;
+            postPointEdit(EDIT_ADD_CURVE, activeCurve, -1, glm::vec3(0.0f));
+            return false;
+        case GLFW_KEY_F: {
+            // Cycle through the vertex formats
+            SceneEdit edit = {};
+            vertexFormat = (VertexFormat)((vertexFormat + 1) % VERTEX_FORMAT_COUNT);
+            edit.type = EDIT_SET_VERTEX_FORMAT;
+            edit.format = vertexFormat;
+            postSceneEdit(edit);
+            cout << "Vertex format: " << vertexFormatName(vertexFormat) << endl;
+            return true;
+        }
+        case GLFW_KEY_S: {
+            // Cycle through the polyline simplification methods
+            SceneEdit edit = {};
+            simplifyMethod = (SimplifyMethod)((simplifyMethod + 1) % SIMPLIFY_METHOD_COUNT);
+            edit.type = EDIT_SET_SIMPLIFY;
+            edit.simplify = simplifyMethod;
+            postSceneEdit(edit);
+            cout << "Simplification: " << simplifyMethodName(simplifyMethod) << endl;
+            return true;
+        }
+        case GLFW_KEY_I: {
+            // List the intersections between the curves of the scene
+            vector<CurveIntersection> hits;
+            IntersectionStats stats;
+            auto start = chrono::steady_clock::now();
+            findSceneIntersections(curves, INTERSECT_TOLERANCE, hits, &stats);
+            double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            cout << "Intersections: " << hits.size() << " (" << elapsedMs << " ms)" << endl;
+            if (stats.exhausted > 0)
+                cout << "  " << stats.exhausted << " curve pairs ran out of clipping steps; their results are Newton-polished" << endl;
+            for (size_t i = 0; i < hits.size() && i < 20; i++)
+                cout << "  curve " << hits[i].curveA << " t=" << hits[i].tA << ", curve " << hits[i].curveB << " t=" << hits[i].tB
+                     << " at (" << hits[i].point.x << ", " << hits[i].point.y << ")" << endl;
+            return false;
+        }
+        case GLFW_KEY_HOME:
+            camera.center = glm::vec2(0.0f, 0.0f);
+            camera.zoom = 1.0f;
+            postViewEdit();
+            return true;
+    }
+    return false;
+}
+
+bool handleFramebufferSize(int width, int height) {
     window_width = width;
     window_height = height;
 
-    glViewport(0, 0, width, height);
+    if (!headless)
+        glViewport(0, 0, width, height);
+
+    /* Az LOD a pixelméretből számolódik, ezért átméretezéskor újratesszelálunk. */
+    postViewEdit();
+    return true;
+}
+
+bool dispatchInputEvent(const InputEvent& event) {
+    switch (event.type) {
+        case INPUT_CURSOR_POS:
+            return handleCursorPos(event.x, event.y);
+        case INPUT_MOUSE_BUTTON:
+            return handleMouseButton(event.button, event.action, event.mods, event.x, event.y);
+        case INPUT_FRAMEBUFFER_SIZE:
+            return handleFramebufferSize((int)event.x, (int)event.y);
+        case INPUT_SCROLL:
+            return handleScroll(event.dx, event.dy, event.x, event.y);
+        case INPUT_KEY:
+            return handleKey(event.key, event.action, event.mods);
+    }
+    return false;
+}
+
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+
+    InputEvent event = { INPUT_KEY, glfwGetTime(), x, y, 0, action, mods, key, 0.0, 0.0 };
+    recordInputEvent(event);
+    dispatchInputEvent(event);
+}
+
+void cursorPosCallback(GLFWwindow* window, double xPos, double yPos) {
+    InputEvent event = { INPUT_CURSOR_POS, glfwGetTime(), xPos, yPos, 0, 0, 0, 0, 0.0, 0.0 };
+    recordInputEvent(event);
+    dispatchInputEvent(event);
+}
+
+void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+
+    InputEvent event = { INPUT_MOUSE_BUTTON, glfwGetTime(), x, y, button, action, mods, 0, 0.0, 0.0 };
+    recordInputEvent(event);
+    dispatchInputEvent(event);
+}
+
+void scrollCallback(GLFWwindow* window, double xOffset, double yOffset) {
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+
+    InputEvent event = { INPUT_SCROLL, glfwGetTime(), x, y, 0, 0, 0, 0, xOffset, yOffset };
+    recordInputEvent(event);
+    dispatchInputEvent(event);
+}
+
+void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    InputEvent event = { INPUT_FRAMEBUFFER_SIZE, glfwGetTime(), (double)width, (double)height, 0, 0, 0, 0, 0.0, 0.0 };
+    recordInputEvent(event);
+    dispatchInputEvent(event);
+}
+
+/* Nagy jelenet a teszteléshez: count darab véletlen görbe egy kb. négyzet alakú területen, rögzített seed-del,
+   hogy a rögzített input trace visszajátszáskor ugyanazt a jelenetet kapja. */
+void generateScene(int count) {
+    mt19937 rng(12345);
+    GLfloat side = 2.0f * sqrtf((GLfloat)count);
+    uniform_real_distribution<GLfloat> position(-side / 2.0f, side / 2.0f);
+    uniform_real_distribution<GLfloat> offset(-0.75f, 0.75f);
+    uniform_int_distribution<int> degree(3, 6);
+
+    for (int c = 0; c < count; c++) {
+        BezierCurve curve;
+        glm::vec2 origin = glm::vec2(position(rng), position(rng));
+        int n = degree(rng);
+
+        for (int i = 0; i <= n; i++)
+            curve.controlPoints.push_back(glm::vec3(origin.x + offset(rng), origin.y + offset(rng), 0.0f));
+        curves.push_back(curve);
+    }
+}
+
+/* Visszajátszáskor az esemény csak akkor számít feldolgozottnak, ha a hozzá tartozó geometria elkészült a worker szálon. */
+bool replayInputEvent(const InputEvent& event) {
+    if (!dispatchInputEvent(event))
+        return false;
+
+    uint64_t edit = lastPostedEdit();
+    for (;;) {
+        acquireLatestGeometry();
+        if (currentGeometry().editSequence >= edit)
+            return true;
+        this_thread::yield();
+    }
+}
+
+/* Az utolsó elkészült képkocka görbementái az egyszerűsítés előtt és után, illetve a feltöltött bájtok ennek megfelelően. */
+void printSimplificationSummary() {
+    const GeometryFrame& frame = currentGeometry();
+    size_t stride = vertexFormatStride(frame.format);
+    size_t removed = frame.tessellatedSamples - frame.simplifiedSamples;
+
+    cout << "Simplification (" << simplifyMethodName(frame.simplify) << "): " << frame.tessellatedSamples << " -> "
+         << frame.simplifiedSamples << " curve vertices ("
+         << (frame.tessellatedSamples > 0 ? 100.0 * removed / frame.tessellatedSamples : 0.0) << "% fewer), "
+         << (frame.packed.size() + removed * stride) / 1024.0 << " -> " << frame.packed.size() / 1024.0 << " KiB per frame" << endl;
+}
+
+void printTessellationCacheSummary() {
+    TessellationCacheStats stats = tessellationCacheStats();
+    uint64_t lookups = stats.hits + stats.misses;
+
+    cout << "Tessellation cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+         << (lookups > 0 ? 100.0 * stats.hits / lookups : 0.0) << "% hit rate), " << stats.evictions << " evictions, "
+         << stats.entries << " entries, " << stats.bytes / 1024.0 << " of " << stats.budget / 1024.0 << " KiB" << endl;
+}
+
+/* Headless visszajátszás: nincs ablak és OpenGL kontextus, csak a geometria készül el. */
+int replayTrace(const char* path) {
+    headless = true;
+    startTessellationWorker(curves, camera, window_width, window_height, vertexFormat, simplifyMethod);
+
+    ReplayStats stats;
+    bool replayed = replayInputTrace(path, replayInputEvent, stats);
+    stopTessellationWorker();
+    if (!replayed)
+        return EXIT_FAILURE;
+
+    size_t controlPointCount = 0;
+    for (const BezierCurve& curve : curves)
+        controlPointCount += curve.controlPoints.size();
+
+    cout << "Replayed " << stats.events << " events, " << stats.geometryEvents << " rebuilt the curve" << endl;
+    cout << "Event-to-geometry latency: p50 " << stats.p50Ms << " ms, p99 " << stats.p99Ms
+         << " ms, max " << stats.maxMs << " ms, total " << stats.totalMs << " ms" << endl;
+    cout << "Final curves: " << curves.size() << " (" << currentGeometry().curveFirsts.size() << " visible), control points: "
+         << controlPointCount << ", vertices: " << currentGeometry().vertices.size() << endl;
+    printSimplificationSummary();
+    printTessellationCacheSummary();
+    return EXIT_SUCCESS;
+}
+
+/* Enyhén hullámos, egyenletes kontrollrács a [-0.8, 0.8]^2 négyzeten. */
+void makeDemoPatch(GLint degree) {
+    patch.degreeU = degree;
+    patch.degreeV = degree;
+    patch.controlPoints.clear();
+    for (GLint a = 0; a <= degree; a++)
+        for (GLint b = 0; b <= degree; b++)
+            patch.controlPoints.push_back(glm::vec3(1.6f * b / degree - 0.8f,
+                                                    1.6f * a / degree - 0.8f + 0.1f * sinf(3.0f * b / degree * 3.14159f), 0.0f));
+    showPatch = true;
+}
+
+void initPatch() {
+    vector<GLuint> indices;
+
+    tessellatePatch(patch, PATCH_RESOLUTION, PATCH_RESOLUTION, patchTessellation);
+    buildPatchStripIndices(PATCH_RESOLUTION, PATCH_RESOLUTION, indices);
+    patchIndexCount = indices.size();
+
+    glGenVertexArrays(1, &patchVAO);
+    glGenBuffers(1, &patchVBO);
+    glGenBuffers(1, &patchIBO);
+
+    glBindVertexArray(patchVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, patchVBO);
+    glBufferData(GL_ARRAY_BUFFER, patchTessellation.vertices.size() * sizeof(glm::vec3), patchTessellation.vertices.data(), GL_DYNAMIC_DRAW);
+    /* Az indexpuffer a VAO állapotának része, ezért a VAO csatolása közben kötjük be. */
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, patchIBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    setVertexAttribFormat(VERTEX_FLOAT3);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    patchTessellation.dirtyFirstRow = -1;
+    patchTessellation.dirtyLastRow = -1;
+}
+
+/* A középső kontrollpontot körpályán mozgatjuk; csak a megváltozott sorokat töltjük fel újra. */
+void drawPatch(double currentTime) {
+    GLint a = patch.degreeU / 2, b = patch.degreeV / 2;
+    glm::vec3 position = glm::vec3(1.6f * b / patch.degreeV - 0.8f, 1.6f * a / patch.degreeU - 0.8f, 0.0f)
+                       + 0.3f * glm::vec3(cosf((GLfloat)currentTime), sinf((GLfloat)currentTime), 0.0f);
+    movePatchControlPoint(patch, a, b, position, patchTessellation);
+
+    glBindVertexArray(patchVAO);
+    if (patchTessellation.dirtyFirstRow >= 0) {
+        GLintptr offset = (GLintptr)patchTessellation.dirtyFirstRow * PATCH_RESOLUTION * sizeof(glm::vec3);
+        GLsizeiptr size = (GLsizeiptr)(patchTessellation.dirtyLastRow - patchTessellation.dirtyFirstRow + 1) * PATCH_RESOLUTION * sizeof(glm::vec3);
+
+        glBindBuffer(GL_ARRAY_BUFFER, patchVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, &patchTessellation.vertices[patchTessellation.dirtyFirstRow * PATCH_RESOLUTION]);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        uploadCount++;
+        uploadedBytes += size;
+        patchTessellation.dirtyFirstRow = -1;
+        patchTessellation.dirtyLastRow = -1;
+    }
+
+    glUniform1i(quantizedLocation, GL_FALSE);
+    glEnable(GL_PRIMITIVE_RESTART);
+    glPrimitiveRestartIndex(PATCH_RESTART_INDEX);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glLineWidth(1.0f);
+    glDrawElements(GL_TRIANGLE_STRIP, patchIndexCount, GL_UNSIGNED_INT, 0);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisable(GL_PRIMITIVE_RESTART);
+    glBindVertexArray(0);
 }
 
 void init(GLFWwindow* window) {
     renderingProgram = createShaderProgram();
-
-    drawBezierCurve(myControlPoints);
+    viewLocation = glGetUniformLocation(renderingProgram, "view");
+    quantizedLocation = glGetUniformLocation(renderingProgram, "quantized");
 
     /* Létrehozzuk a szükséges Vertex buffer és vertex array objektumot. */
     glGenBuffers(numVBOs, VBO);
     glGenVertexArrays(numVAOs, VAO);
 
+    /* A görbék tesszelálását a háttérszál végzi; az elkészült geometriát a display tölti fel a pufferbe. */
+    startTessellationWorker(curves, camera, window_width, window_height, vertexFormat, simplifyMethod);
+
     /* Típus meghatározása: a GL_ARRAY_BUFFER nevesített csatolóponthoz kapcsoljuk a buffert (ide kerülnek a vertex adatok). */
     glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
 
-    /* Másoljuk az adatokat a pufferbe! Megadjuk az aktuálisan csatolt puffert,  azt hogy hány bájt adatot másolunk,
-    a másolandó adatot, majd a feldolgozás módját is meghatározzuk: most az adat nem változik a feltöltés után */
-    glBufferData(GL_ARRAY_BUFFER, pointToDraw.size() * sizeof(glm::vec3), pointToDraw.data(), GL_STATIC_DRAW);
-
     /* Csatoljuk a vertex array objektumunkat a konfiguráláshoz. */
     glBindVertexArray(VAO[0]);
 
@@ -355,8 +717,9 @@ void init(GLFWwindow* window) {
     Harmadik az adat típusa.
     Negyedik az adat normalizálása, ez maradhat FALSE jelen példában.
     Az attribútum értékek hogyan következnek egymás után? Milyen lépésköz után találom a következő vertex adatait?
-    Végül megadom azt, hogy honnan kezdődnek az értékek a pufferben. Most rögtön, a legelejétől veszem őket.*/
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    Végül megadom azt, hogy honnan kezdődnek az értékek a pufferben. Most rögtön, a legelejétől veszem őket.
+    A formátumot az updateVBO állítja át, ha a worker más kódolású geometriát ad. */
+    setVertexAttribFormat(vboFormat);
 
     /* Engedélyezzük az imént definiált 0 indexű attribútumot. */
     glEnableVertexAttribArray(0);
@@ -365,40 +728,194 @@ void init(GLFWwindow* window) {
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    if (showPatch)
+        initPatch();
+
     // aktiváljuk a shader-program objektumunkat.
     glUseProgram(renderingProgram);
 
+    /* A kvantálási táblák buffer textúrái végig ugyanazon a textúraegységen maradnak, csak a tartalmuk cserélődik. */
+    const GLenum quantizationFormats[3] = { GL_RGBA32F, GL_R32I, GL_R32I };
+    const char*  quantizationSamplers[3] = { "quantizationBoxes", "quantizationFirsts", "quantizationBlocks" };
+    glGenBuffers(3, quantizationBuffers);
+    glGenTextures(3, quantizationTextures);
+    for (int i = 0; i < 3; i++) {
+        glBindBuffer(GL_TEXTURE_BUFFER, quantizationBuffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4), NULL, GL_STATIC_DRAW);
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_BUFFER, quantizationTextures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, quantizationFormats[i], quantizationBuffers[i]);
+        glUniform1i(glGetUniformLocation(renderingProgram, quantizationSamplers[i]), i);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+
     glClearColor(0.0, 0.0, 0.0, 1.0);
 }
 
 /** A jelenetünk utáni takarítás. */
 void cleanUpScene() {
+    stopTessellationWorker();
+
     /** Töröljük a vertex puffer és vertex array objektumokat. */
     glDeleteVertexArrays(numVAOs, VAO);
     glDeleteBuffers(numVBOs, VBO);
+    glDeleteTextures(3, quantizationTextures);
+    glDeleteBuffers(3, quantizationBuffers);
+    if (showPatch) {
+        glDeleteVertexArrays(1, &patchVAO);
+        glDeleteBuffers(1, &patchVBO);
+        glDeleteBuffers(1, &patchIBO);
+    }
 
     /** Töröljük a shader programot. */
     glDeleteProgram(renderingProgram);
 }
 
+/* Képkockánként feljegyezzük, mennyire maradt le a kirajzolt geometria a beérkezett módosításoktól. */
+void trackStaleness() {
+    GeometryStaleness staleness = currentStaleness();
+
+    displayedFrames++;
+    if (staleness.editsBehind > 0)
+        staleFrames++;
+    if (staleness.editsBehind > maxEditsBehind)
+        maxEditsBehind = staleness.editsBehind;
+    if (staleness.latencyMs > maxLatencyMs)
+        maxLatencyMs = staleness.latencyMs;
+}
+
+void printStalenessSummary() {
+    cout << "Frames: " << displayedFrames << ", drawn with pending edits: " << staleFrames
+         << ", max edits behind: " << maxEditsBehind << ", max edit-to-geometry latency: " << maxLatencyMs << " ms" << endl;
+    cout << "Uploads: " << uploadCount << ", " << uploadedBytes / 1024.0 << " KiB in total, "
+         << (uploadCount > 0 ? uploadedBytes / 1024.0 / uploadCount : 0.0) << " KiB per upload" << endl;
+    printSimplificationSummary();
+    printTessellationCacheSummary();
+}
+
+/* Batch export: pontos tesszelálás (a CPU összes szálán vagy compute shaderrel), egyszerűsítés, SVG kimenet. */
+int exportScene(const char* path, GLfloat tolerance, bool gpu) {
+    ExportStats stats;
+
+    if (gpu) {
+        /* Külön rejtett ablak 4.3-as kontextussal; macOS-en a 4.1 a felső határ, ott ez nem sikerül. */
+        GLFWwindow* context = createComputeContext();
+        if (context == NULL) {
+            cerr << "The GPU export needs OpenGL 4.3 (compute shaders); use --export-backend cpu." << endl;
+            return EXIT_FAILURE;
+        }
+        cout << "Compute context: " << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION) << endl;
+
+        bool exported = initComputeTessellation() && exportSceneSVGCompute(path, curves, tolerance, simplifyMethod, stats);
+        cleanUpComputeTessellation();
+        destroyComputeContext(context);
+        if (!exported)
+            return EXIT_FAILURE;
+    }
+    else if (!exportSceneSVG(path, curves, tolerance, simplifyMethod, stats))
+        return EXIT_FAILURE;
+
+    size_t removed = stats.tessellatedVertices - stats.exportedVertices;
+    cout << "Exported " << stats.curves << " curves to " << path << " (" << simplifyMethodName(simplifyMethod)
+         << ", tolerance " << tolerance << "): " << stats.tessellatedVertices << " -> " << stats.exportedVertices << " vertices ("
+         << (stats.tessellatedVertices > 0 ? 100.0 * removed / stats.tessellatedVertices : 0.0) << "% fewer), "
+         << stats.tessellatedVertices * sizeof(glm::vec2) / 1024.0 << " -> " << stats.exportedVertices * sizeof(glm::vec2) / 1024.0
+         << " KiB of coordinates, " << stats.fileBytes / 1024.0 << " KiB written" << endl;
+    cout << "Export time: " << stats.totalMs << " ms in total; tessellation " << stats.tessellateMs << " ms "
+         << (stats.gpu ? "(compute shader upload, dispatch, wait and readback)" : "(CPU)") << ", simplification "
+         << stats.simplifyMs << " ms on " << stats.threads << " threads, writing " << stats.writeMs << " ms" << endl;
+    return EXIT_SUCCESS;
+}
+
 void display(GLFWwindow* window, double currentTime) {
     glClear(GL_COLOR_BUFFER_BIT); // fontos lehet minden egyes alkalommal törölni!
 
+    /* Soha nem várunk a tesszelálásra: ha van újabb kész geometria, azt töltjük fel, különben a régit rajzoljuk. */
+    if (acquireLatestGeometry())
+        updateVBO(currentGeometry());
+    trackStaleness();
+
+    const GeometryFrame& frame = currentGeometry();
+
+    glm::mat4 view = viewMatrix(camera);
+    glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view));
+
+    if (showPatch)
+        drawPatch(currentTime);
+
     /*Csatoljuk a vertex array objektumunkat. */
     glBindVertexArray(VAO[0]);
     glLineWidth(2.0f);
     glPointSize(7.0f);
     glEnable(GL_POINT_SMOOTH);
     glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-    glDrawArrays(GL_LINE_STRIP, 0, pointToDraw.size() - myControlPoints.size());
-    //glDrawArrays(GL_LINE_STRIP, pointToDraw.size() - myControlPoints.size(), myControlPoints.size());
-    glDrawArrays(GL_POINTS, pointToDraw.size() - myControlPoints.size(), myControlPoints.size());
+
+    /* Minden látható görbe egyetlen hívással: előbb a görbék, aztán a kontrollpontjaik. int16-nál a
+       görbénkénti dobozt a vertex shader keresi ki a buffer textúrákból. */
+    glUniform1i(quantizedLocation, frame.format == VERTEX_INT16);
+    glMultiDrawArrays(GL_LINE_STRIP, frame.curveFirsts.data(), frame.curveCounts.data(), frame.curveFirsts.size());
+    glMultiDrawArrays(GL_POINTS, frame.pointFirsts.data(), frame.pointCounts.data(), frame.pointFirsts.size());
     
     /* Leválasztjuk, nehogy bármilyen érték felülíródjon.*/
     glBindVertexArray(0);
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    const char* exportPath = NULL;
+    GLfloat exportTolerance = EXPORT_TOLERANCE;
+    bool exportGPU = false;
+
+    /* --record <fájl>: az input események naplózása, --replay <fájl>: headless visszajátszás mérésekkel,
+       --scene <n>: n darab véletlen görbe hozzáadása a jelenethez, --bench <név>: mérések ablak nélkül,
+       --vertex-format <float3|float2|half|int16>: a VBO-ba feltöltött vertexek kódolása,
+       --patch <fokszám>: Bézier-felületdarab megjelenítése a görbék mögött,
+       --simplify <none|douglas-peucker|visvalingam>: a töröttvonal-egyszerűsítés módszere,
+       --export <fájl.svg>, --export-tolerance <világegység>: a jelenet kiírása ablak nélkül,
+       --export-backend <cpu|gpu>: a kiírt görbék tesszelálása a CPU szálain vagy compute shaderrel (OpenGL 4.3),
+       --cache-budget <MiB>: a tesszelálási gyorsítótár memóriakerete (0: kikapcsolva). */
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--scene") == 0)
+            generateScene(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--bench") == 0)
+            exit(runBenchmark(argv[++i]));
+        else if (strcmp(argv[i], "--vertex-format") == 0 && !parseVertexFormat(argv[++i], vertexFormat)) {
+            cerr << "Unknown vertex format: " << argv[i] << endl;
+            exit(EXIT_FAILURE);
+        }
+        else if (strcmp(argv[i], "--patch") == 0)
+            makeDemoPatch(max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--simplify") == 0 && !parseSimplifyMethod(argv[++i], simplifyMethod)) {
+            cerr << "Unknown simplification method: " << argv[i] << endl;
+            exit(EXIT_FAILURE);
+        }
+        else if (strcmp(argv[i], "--export") == 0)
+            exportPath = argv[++i];
+        else if (strcmp(argv[i], "--export-tolerance") == 0)
+            exportTolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--export-backend") == 0) {
+            exportGPU = strcmp(argv[++i], "gpu") == 0;
+            if (!exportGPU && strcmp(argv[i], "cpu") != 0) {
+                cerr << "Unknown export backend: " << argv[i] << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--cache-budget") == 0)
+            setTessellationCacheBudget((size_t)(atof(argv[++i]) * 1024.0 * 1024.0));
+    }
+
+    if (exportPath != NULL)
+        exit(exportScene(exportPath, exportTolerance, exportGPU));
+
+    if (replayPath != NULL)
+        exit(replayTrace(replayPath));
+
     /* Próbáljuk meg inicializálni a GLFW-t! */
     if (!glfwInit()) { exit(EXIT_FAILURE); }
 
@@ -415,6 +932,7 @@ int main(void) {
     glfwSetKeyCallback(window, keyCallback);
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetScrollCallback(window, scrollCallback);
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
 
     /* Incializáljuk a GLEW-t, hogy elérhetővé váljanak az OpenGL függvények. */
@@ -424,6 +942,12 @@ int main(void) {
     /* Az alkalmazáshoz kapcsolódó előkészítő lépések, pl. hozd létre a shader objektumokat. */
     init(window);
 
+    if (recordPath != NULL && startInputRecording(recordPath)) {
+        /* A kiinduló ablakméretet is rögzítjük, hogy a koordináta-normalizálás visszajátszáskor is egyezzen. */
+        InputEvent sizeEvent = { INPUT_FRAMEBUFFER_SIZE, glfwGetTime(), (double)window_width, (double)window_height, 0, 0, 0, 0, 0.0, 0.0 };
+        recordInputEvent(sizeEvent);
+    }
+
     while (!glfwWindowShouldClose(window)) {
         /* a kód, amellyel rajzolni tudunk a GLFWwindow ojektumunkba. */
         display(window, glfwGetTime());
@@ -433,11 +957,14 @@ int main(void) {
         glfwPollEvents();
     }
 
+    stopInputRecording();
+
     /* töröljük a GLFW ablakot. */
     glfwDestroyWindow(window);
     /* Leállítjuk a GLFW-t */
 
     cleanUpScene();
+    printStalenessSummary();
 
     glfwTerminate();
     exit(EXIT_SUCCESS);
@@ -0,0 +1,171 @@
+//
+//  patch.cpp
+//  mac_opengl_setup_example
+//
+
+#include "patch.h"
+#include "bezier.h"
+
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+static map<pair<GLint, GLint>, BasisTable> basisTables;
+static mutex basisTablesMutex;
+
+const BasisTable& basisTable(GLint degree, GLint resolution) {
+    lock_guard<mutex> lock(basisTablesMutex);
+
+    BasisTable& table = basisTables[make_pair(degree, resolution)];
+    if (table.values.empty()) {
+        table.degree = degree;
+        table.resolution = resolution;
+        table.values.resize(resolution * (degree + 1));
+
+        /* Soronként de Casteljau-szerű rekurzióval: B(r, i) = (1 - t) B(r-1, i) + t B(r-1, i-1), pow és NCR nélkül. */
+        for (GLint s = 0; s < resolution; s++) {
+            GLfloat  t = resolution > 1 ? (GLfloat)s / (resolution - 1) : 0.0f;
+            GLfloat* row = &table.values[s * (degree + 1)];
+
+            row[0] = 1.0f;
+            for (GLint r = 1; r <= degree; r++) {
+                row[r] = t * row[r - 1];
+                for (GLint i = r - 1; i > 0; i--)
+                    row[i] = (1.0f - t) * row[i] + t * row[i - 1];
+                row[0] = (1.0f - t) * row[0];
+            }
+        }
+    }
+    return table;
+}
+
+/* partial[i][b] = sum_a Bu[i][a] P(a, b) a b oszlopra */
+static void updatePartialColumn(const BezierPatch& patch, const BasisTable& bu, GLint b, PatchTessellation& tess) {
+    GLint columns = patch.degreeV + 1;
+
+    for (GLint i = 0; i < tess.resolutionU; i++) {
+        const GLfloat* basis = &bu.values[i * (patch.degreeU + 1)];
+        glm::vec3 sum = glm::vec3(0.0f, 0.0f, 0.0f);
+
+        for (GLint a = 0; a <= patch.degreeU; a++)
+            sum += patch.controlPoints[a * columns + b] * basis[a];
+        tess.partial[i * columns + b] = sum;
+    }
+}
+
+/* vertices[i][j] = sum_b partial[i][b] Bv[j][b] a megadott téglalapon */
+static void updateVertices(const BezierPatch& patch, const BasisTable& bv, GLint firstRow, GLint lastRow,
+                           GLint firstColumn, GLint lastColumn, PatchTessellation& tess) {
+    GLint columns = patch.degreeV + 1;
+
+    for (GLint i = firstRow; i <= lastRow; i++) {
+        const glm::vec3* partialRow = &tess.partial[i * columns];
+        glm::vec3* vertexRow = &tess.vertices[i * tess.resolutionV];
+
+        for (GLint j = firstColumn; j <= lastColumn; j++) {
+            const GLfloat* basis = &bv.values[j * columns];
+            glm::vec3 sum = glm::vec3(0.0f, 0.0f, 0.0f);
+
+            for (GLint b = 0; b < columns; b++)
+                sum += partialRow[b] * basis[b];
+            vertexRow[j] = sum;
+        }
+    }
+}
+
+static void markDirty(PatchTessellation& tess, GLint firstRow, GLint lastRow) {
+    if (tess.dirtyFirstRow == -1 || firstRow < tess.dirtyFirstRow)
+        tess.dirtyFirstRow = firstRow;
+    if (lastRow > tess.dirtyLastRow)
+        tess.dirtyLastRow = lastRow;
+}
+
+void tessellatePatch(const BezierPatch& patch, GLint resolutionU, GLint resolutionV, PatchTessellation& out) {
+    const BasisTable& bu = basisTable(patch.degreeU, resolutionU);
+    const BasisTable& bv = basisTable(patch.degreeV, resolutionV);
+
+    out.resolutionU = resolutionU;
+    out.resolutionV = resolutionV;
+    out.partial.resize(resolutionU * (patch.degreeV + 1));
+    out.vertices.resize(resolutionU * resolutionV);
+    out.skippedError = 0.0f;
+
+    for (GLint b = 0; b <= patch.degreeV; b++)
+        updatePartialColumn(patch, bu, b, out);
+    updateVertices(patch, bv, 0, resolutionU - 1, 0, resolutionV - 1, out);
+    markDirty(out, 0, resolutionU - 1);
+}
+
+/* A Bernstein-polinom unimodális, így a küszöb feletti minták egyetlen összefüggő tartományt adnak. */
+static bool basisSupport(const BasisTable& table, GLint index, GLint& outFirst, GLint& outLast) {
+    outFirst = -1;
+    outLast = -1;
+
+    for (GLint s = 0; s < table.resolution; s++)
+        if (table.values[s * (table.degree + 1) + index] >= PATCH_BASIS_EPSILON) {
+            if (outFirst == -1)
+                outFirst = s;
+            outLast = s;
+        }
+    return outFirst != -1;
+}
+
+size_t movePatchControlPoint(BezierPatch& patch, GLint a, GLint b, glm::vec3 position, PatchTessellation& tess) {
+    const BasisTable& bu = basisTable(patch.degreeU, tess.resolutionU);
+    const BasisTable& bv = basisTable(patch.degreeV, tess.resolutionV);
+    glm::vec3& P = patch.controlPoints[a * (patch.degreeV + 1) + b];
+    GLfloat moved = glm::length(position - P);
+
+    P = position;
+
+    /* A köztes mátrix b oszlopa pontosan újraszámolható, így a hiba nem halmozódik benne. */
+    updatePartialColumn(patch, bu, b, tess);
+
+    /* A tartományon kívül Bu * Bv < epsilon, a kihagyott változás így legfeljebb epsilon * elmozdulás. */
+    tess.skippedError += PATCH_BASIS_EPSILON * moved;
+    if (tess.skippedError > PATCH_MAX_SKIPPED_ERROR) {
+        updateVertices(patch, bv, 0, tess.resolutionU - 1, 0, tess.resolutionV - 1, tess);
+        markDirty(tess, 0, tess.resolutionU - 1);
+        tess.skippedError = 0.0f;
+        return tess.vertices.size();
+    }
+
+    GLint firstRow, lastRow, firstColumn, lastColumn;
+    if (!basisSupport(bu, a, firstRow, lastRow) || !basisSupport(bv, b, firstColumn, lastColumn))
+        return 0;
+
+    updateVertices(patch, bv, firstRow, lastRow, firstColumn, lastColumn, tess);
+    markDirty(tess, firstRow, lastRow);
+    return (size_t)(lastRow - firstRow + 1) * (lastColumn - firstColumn + 1);
+}
+
+void buildPatchStripIndices(GLint resolutionU, GLint resolutionV, vector<GLuint>& out) {
+    out.clear();
+    out.reserve((resolutionU - 1) * (2 * resolutionV + 1));
+
+    for (GLint i = 0; i + 1 < resolutionU; i++) {
+        for (GLint j = 0; j < resolutionV; j++) {
+            out.push_back(i * resolutionV + j);
+            out.push_back((i + 1) * resolutionV + j);
+        }
+        out.push_back(PATCH_RESTART_INDEX);
+    }
+}
+
+void tessellatePatchNaive(const BezierPatch& patch, GLint resolutionU, GLint resolutionV, vector<glm::vec3>& out) {
+    out.resize(resolutionU * resolutionV);
+
+    for (GLint i = 0; i < resolutionU; i++)
+        for (GLint j = 0; j < resolutionV; j++) {
+            GLfloat u = (GLfloat)i / (resolutionU - 1);
+            GLfloat v = (GLfloat)j / (resolutionV - 1);
+            glm::vec3 sum = glm::vec3(0.0f, 0.0f, 0.0f);
+
+            for (GLint a = 0; a <= patch.degreeU; a++)
+                for (GLint b = 0; b <= patch.degreeV; b++)
+                    sum += patch.controlPoints[a * (patch.degreeV + 1) + b] *
+                           (blending(patch.degreeU, a, u) * blending(patch.degreeV, b, v));
+            out[i * resolutionV + j] = sum;
+        }
+}
@@ -0,0 +1,61 @@
+//
+//  patch.h
+//  mac_opengl_setup_example
+//
+//  Tensor-product Bézier patches. A (u, v) grid is evaluated as two basis matrix products,
+//  S = Bu * P * Bv^T, with the Bernstein tables cached per (degree, resolution) and shared by all patches.
+//
+
+#ifndef patch_h
+#define patch_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/* Az ennél kisebb bázisértékű sorokat/oszlopokat egy kontrollpont mozgatásakor nem számoljuk újra. */
+#define PATCH_BASIS_EPSILON 1e-4f
+
+/* Ha a kihagyott tagok összegzett hibája ezt meghaladja, a teljes rácsot újraszámoljuk. */
+#define PATCH_MAX_SKIPPED_ERROR 1e-4f
+
+#define PATCH_RESTART_INDEX 0xFFFFFFFFu
+
+/* resolution rows of degree + 1 Bernstein values, sampled at t = 0, 1/(resolution-1), ..., 1. */
+struct BasisTable {
+    GLint degree;
+    GLint resolution;
+    std::vector<GLfloat> values;
+};
+
+/* (degreeU + 1) rows of (degreeV + 1) control points, P(a, b) = controlPoints[a * (degreeV + 1) + b]. */
+struct BezierPatch {
+    GLint degreeU, degreeV;
+    std::vector<glm::vec3> controlPoints;
+};
+
+struct PatchTessellation {
+    GLint resolutionU = 0, resolutionV = 0;
+    std::vector<glm::vec3> partial;     // Bu * P, resolutionU rows of degreeV + 1
+    std::vector<glm::vec3> vertices;    // resolutionU rows of resolutionV, row-major
+    GLfloat skippedError = 0.0f;        // upper bound of the error left by partial updates
+    GLint dirtyFirstRow = -1;           // rows changed since the last upload, -1 if none
+    GLint dirtyLastRow = -1;
+};
+
+/* Cached and shared between patches; the returned reference stays valid. */
+const BasisTable& basisTable(GLint degree, GLint resolution);
+
+void tessellatePatch(const BezierPatch& patch, GLint resolutionU, GLint resolutionV, PatchTessellation& out);
+
+/* Moves P(a, b) and updates only the grid region where its basis function is not negligible.
+   Returns the number of vertices recomputed. */
+size_t movePatchControlPoint(BezierPatch& patch, GLint a, GLint b, glm::vec3 position, PatchTessellation& tess);
+
+/* One triangle strip per pair of grid rows, separated by PATCH_RESTART_INDEX. */
+void buildPatchStripIndices(GLint resolutionU, GLint resolutionV, std::vector<GLuint>& out);
+
+/* Per-sample reference evaluation with blending(), for benchmarks and checks. */
+void tessellatePatchNaive(const BezierPatch& patch, GLint resolutionU, GLint resolutionV, std::vector<glm::vec3>& out);
+
+#endif /* patch_h */
@@ -0,0 +1,183 @@
+//
+//  simplify.cpp
+//  mac_opengl_setup_example
+//
+
+#include "simplify.h"
+
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+#include <queue>
+#include <thread>
+
+using namespace std;
+
+static const char* methodNames[SIMPLIFY_METHOD_COUNT] = { "none", "douglas-peucker", "visvalingam" };
+
+const char* simplifyMethodName(SimplifyMethod method) {
+    return methodNames[method];
+}
+
+bool parseSimplifyMethod(const char* name, SimplifyMethod& outMethod) {
+    for (int i = 0; i < SIMPLIFY_METHOD_COUNT; i++)
+        if (strcmp(name, methodNames[i]) == 0) {
+            outMethod = (SimplifyMethod)i;
+            return true;
+        }
+    return false;
+}
+
+static GLfloat distanceToSegment(glm::vec3 P, glm::vec3 A, glm::vec3 B) {
+    glm::vec2 AB = glm::vec2(B - A), AP = glm::vec2(P - A);
+    GLfloat lengthSquared = glm::dot(AB, AB);
+    GLfloat t = lengthSquared > 0.0f ? fminf(fmaxf(glm::dot(AP, AB) / lengthSquared, 0.0f), 1.0f) : 0.0f;
+
+    return glm::length(AP - AB * t);
+}
+
+/* A [first, last] közötti pontok legnagyobb távolsága a first-last szakasztól. */
+static GLfloat spanError(const glm::vec3* points, GLsizei first, GLsizei last, GLsizei* outFarthest) {
+    GLfloat error = 0.0f;
+
+    for (GLsizei i = first + 1; i < last; i++) {
+        GLfloat distance = distanceToSegment(points[i], points[first], points[last]);
+        if (distance > error) {
+            error = distance;
+            if (outFarthest != NULL)
+                *outFarthest = i;
+        }
+    }
+    return error;
+}
+
+/* Douglas–Peucker, saját veremmel (a rekurzió mélysége a pontok számáig nőhetne). */
+static void douglasPeucker(const glm::vec3* points, GLsizei count, GLfloat tolerance, unsigned char* keep) {
+    vector<pair<GLsizei, GLsizei>> stack;
+
+    stack.push_back(make_pair(0, count - 1));
+    while (!stack.empty()) {
+        GLsizei first = stack.back().first, last = stack.back().second;
+        GLsizei farthest = first;
+        stack.pop_back();
+
+        if (last - first < 2 || spanError(points, first, last, &farthest) <= tolerance)
+            continue;
+
+        keep[farthest] = 1;
+        stack.push_back(make_pair(first, farthest));
+        stack.push_back(make_pair(farthest, last));
+    }
+}
+
+struct AreaEntry {
+    GLfloat area;
+    GLsizei index;
+    unsigned version;
+
+    bool operator<(const AreaEntry& other) const { return area > other.area; }   // min-heap
+};
+
+/*
+Visvalingam–Whyatt: mindig a legkisebb háromszögterületű pontot hagyjuk el. A terület csak a sorrendet adja; elhagyni
+csak akkor szabad, ha az új szakasz minden addig elhagyott eredeti ponttól tolerancián belül marad, így a hibakorlát
+ugyanaz, mint a Douglas–Peuckernél.
+*/
+static void visvalingamWhyatt(const glm::vec3* points, GLsizei count, GLfloat tolerance, unsigned char* keep) {
+    vector<GLsizei> previous(count), next(count);
+    vector<unsigned> version(count, 0);
+    priority_queue<AreaEntry> heap;
+
+    auto area = [&](GLsizei i) {
+        glm::vec2 a = glm::vec2(points[i] - points[previous[i]]), b = glm::vec2(points[next[i]] - points[previous[i]]);
+        return fabsf(a.x * b.y - a.y * b.x) / 2.0f;
+    };
+
+    for (GLsizei i = 0; i < count; i++) {
+        previous[i] = i - 1;
+        next[i] = i + 1;
+        keep[i] = 1;
+    }
+    for (GLsizei i = 1; i + 1 < count; i++)
+        heap.push({ area(i), i, 0 });
+
+    while (!heap.empty()) {
+        AreaEntry entry = heap.top();
+        heap.pop();
+        if (!keep[entry.index] || entry.version != version[entry.index])
+            continue;
+
+        GLsizei p = previous[entry.index], n = next[entry.index];
+        if (spanError(points, p, n, NULL) > tolerance)
+            continue;   // a szomszédok változásakor újra sorra kerül
+
+        keep[entry.index] = 0;
+        next[p] = n;
+        previous[n] = p;
+        if (p > 0)
+            heap.push({ area(p), p, ++version[p] });
+        if (n < count - 1)
+            heap.push({ area(n), n, ++version[n] });
+    }
+}
+
+GLsizei simplifyPolyline(const glm::vec3* points, GLsizei count, GLfloat tolerance, SimplifyMethod method,
+                         unsigned char* outKeep) {
+    if (count <= 2 || method == SIMPLIFY_NONE) {
+        memset(outKeep, 1, count);
+        return count;
+    }
+
+    if (method == SIMPLIFY_DOUGLAS_PEUCKER) {
+        memset(outKeep, 0, count);
+        outKeep[0] = 1;
+        outKeep[count - 1] = 1;
+        douglasPeucker(points, count, tolerance, outKeep);
+    }
+    else
+        visvalingamWhyatt(points, count, tolerance, outKeep);
+
+    GLsizei kept = 0;
+    for (GLsizei i = 0; i < count; i++)
+        kept += outKeep[i];
+    return kept;
+}
+
+void simplifyRanges(const vector<glm::vec3>& vertices, const vector<GLint>& firsts, const vector<GLsizei>& counts,
+                    GLfloat tolerance, SimplifyMethod method, unsigned threads, vector<unsigned char>& outKeep) {
+    outKeep.assign(vertices.size(), 1);
+
+    /* A görbék egymástól függetlenek: minden szál a tartományok egy összefüggő szeletét kapja, a jelzők nem fedik egymást. */
+    auto simplifySlice = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            simplifyPolyline(&vertices[firsts[i]], counts[i], tolerance, method, &outKeep[firsts[i]]);
+    };
+
+    threads = max(1u, min(threads, (unsigned)firsts.size()));
+    if (threads == 1) {
+        simplifySlice(0, firsts.size());
+        return;
+    }
+
+    vector<thread> workers;
+    size_t perThread = (firsts.size() + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++) {
+        size_t begin = t * perThread, end = min(firsts.size(), begin + perThread);
+        if (begin < end)
+            workers.push_back(thread(simplifySlice, begin, end));
+    }
+    for (thread& worker : workers)
+        worker.join();
+}
+
+GLfloat simplificationError(const glm::vec3* points, GLsizei count, const unsigned char* keep) {
+    GLfloat error = 0.0f;
+    GLsizei first = 0;
+
+    for (GLsizei i = 1; i < count; i++)
+        if (keep[i]) {
+            error = fmaxf(error, spanError(points, first, i, NULL));
+            first = i;
+        }
+    return error;
+}
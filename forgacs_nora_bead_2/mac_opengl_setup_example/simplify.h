@@ -0,0 +1,46 @@
+//
+//  simplify.h
+//  mac_opengl_setup_example
+//
+//  Polyline simplification after tessellation (Douglas–Peucker or Visvalingam–Whyatt), used both
+//  for the frames sent to the GPU and for batch export.
+//
+
+#ifndef simplify_h
+#define simplify_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+enum SimplifyMethod {
+    SIMPLIFY_NONE = 0,
+    SIMPLIFY_DOUGLAS_PEUCKER = 1,
+    SIMPLIFY_VISVALINGAM = 2,
+};
+
+#define SIMPLIFY_METHOD_COUNT 3
+
+/* A kirajzolt görbék egyszerűsítésének tűrése képernyőpixelben (a köbös közelítés hibája mellé adódik). */
+#define SIMPLIFY_PIXEL_TOLERANCE 0.25f
+
+const char* simplifyMethodName(SimplifyMethod method);
+bool parseSimplifyMethod(const char* name, SimplifyMethod& outMethod);
+
+/*
+Marks the points of the polyline to keep in outKeep (count flags). The endpoints are always kept, and every
+dropped point is within tolerance of the simplified polyline. Returns the number of points kept.
+*/
+GLsizei simplifyPolyline(const glm::vec3* points, GLsizei count, GLfloat tolerance, SimplifyMethod method,
+                         unsigned char* outKeep);
+
+/* Simplifies every [first, first + count) range of vertices on its own, split between threads
+   (1: on the calling thread). outKeep gets one flag per vertex; vertices outside the ranges are kept. */
+void simplifyRanges(const std::vector<glm::vec3>& vertices, const std::vector<GLint>& firsts,
+                    const std::vector<GLsizei>& counts, GLfloat tolerance, SimplifyMethod method,
+                    unsigned threads, std::vector<unsigned char>& outKeep);
+
+/* Largest distance of the original points from the kept polyline (for checks and benchmarks). */
+GLfloat simplificationError(const glm::vec3* points, GLsizei count, const unsigned char* keep);
+
+#endif /* simplify_h */
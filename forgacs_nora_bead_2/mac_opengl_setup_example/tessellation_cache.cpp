@@ -0,0 +1,148 @@
+//
+//  tessellation_cache.cpp
+//  mac_opengl_setup_example
+//
+
+#include "tessellation_cache.h"
+
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+struct CacheEntry {
+    uint64_t hash;
+    vector<glm::vec3> controlPoints;     // a teljes kulcs, hogy egy hash-ütközés ne adjon rossz geometriát
+    TessellationSettings settings;
+    vector<glm::vec3> samples;
+    GLsizei tessellatedCount;
+    size_t bytes;
+};
+
+/* A lista eleje a legutóbb használt bejegyzés; a hash-tábla a listaelemekre mutat. */
+static mutex cacheMutex;
+static list<CacheEntry> recency;
+static unordered_map<uint64_t, list<CacheEntry>::iterator> entries;
+static size_t cacheBytes = 0;
+static size_t cacheBudget = TESSELLATION_CACHE_BUDGET;
+static uint64_t hits = 0, misses = 0, evictions = 0;
+
+/* FNV-1a a float értékek bitmintáján; a -0.0-t +0.0-ra cseréljük, hogy az egyenlő pontok egyenlő hash-t kapjanak. */
+static void hashFloat(uint64_t& hash, GLfloat value) {
+    uint32_t bits;
+    value += 0.0f;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        hash ^= (bits >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ull;
+    }
+}
+
+uint64_t hashTessellationKey(const vector<glm::vec3>& controlPoints, const TessellationSettings& settings) {
+    uint64_t hash = 14695981039346656037ull;
+
+    hashFloat(hash, (GLfloat)controlPoints.size() - 1);     // degree
+    for (const glm::vec3& p : controlPoints) {
+        hashFloat(hash, p.x);
+        hashFloat(hash, p.y);
+        hashFloat(hash, p.z);
+    }
+    hashFloat(hash, settings.cubicTolerance);
+    hashFloat(hash, settings.pixelsPerUnit);
+    hashFloat(hash, (GLfloat)settings.simplify);
+    hashFloat(hash, settings.simplifyTolerance);
+    return hash;
+}
+
+static bool sameKey(const CacheEntry& entry, const vector<glm::vec3>& controlPoints, const TessellationSettings& settings) {
+    return entry.controlPoints == controlPoints
+        && entry.settings.cubicTolerance == settings.cubicTolerance
+        && entry.settings.pixelsPerUnit == settings.pixelsPerUnit
+        && entry.settings.simplify == settings.simplify
+        && entry.settings.simplifyTolerance == settings.simplifyTolerance;
+}
+
+static void evictEntry(list<CacheEntry>::iterator it) {
+    cacheBytes -= it->bytes;
+    entries.erase(it->hash);
+    recency.erase(it);
+}
+
+static void evictToBudget(size_t budget) {
+    while (cacheBytes > budget && !recency.empty()) {
+        evictEntry(prev(recency.end()));
+        evictions++;
+    }
+}
+
+bool lookupTessellation(const vector<glm::vec3>& controlPoints, const TessellationSettings& settings,
+                        vector<glm::vec3>& out, GLsizei& outTessellatedCount) {
+    uint64_t hash = hashTessellationKey(controlPoints, settings);
+    lock_guard<mutex> lock(cacheMutex);
+
+    auto found = entries.find(hash);
+    if (found == entries.end() || !sameKey(*found->second, controlPoints, settings)) {
+        misses++;
+        return false;
+    }
+
+    recency.splice(recency.begin(), recency, found->second);
+    out.insert(out.end(), found->second->samples.begin(), found->second->samples.end());
+    outTessellatedCount = found->second->tessellatedCount;
+    hits++;
+    return true;
+}
+
+void storeTessellation(const vector<glm::vec3>& controlPoints, const TessellationSettings& settings,
+                       const glm::vec3* samples, GLsizei count, GLsizei tessellatedCount) {
+    /* A becsült méret: a két vektor tartalma, plusz a lista- és hash-tábla csomópont. */
+    size_t bytes = sizeof(CacheEntry) + 4 * sizeof(void*) + (controlPoints.size() + count) * sizeof(glm::vec3);
+    uint64_t hash = hashTessellationKey(controlPoints, settings);
+    lock_guard<mutex> lock(cacheMutex);
+
+    if (bytes > cacheBudget)
+        return;
+
+    /* Ugyanazon a címen régebbi (vagy ütköző) bejegyzés: lecseréljük. */
+    auto found = entries.find(hash);
+    if (found != entries.end())
+        evictEntry(found->second);
+
+    CacheEntry entry = { hash, controlPoints, settings, vector<glm::vec3>(samples, samples + count), tessellatedCount, bytes };
+    recency.push_front(entry);
+    entries[hash] = recency.begin();
+    cacheBytes += bytes;
+    evictToBudget(cacheBudget);
+}
+
+void setTessellationCacheBudget(size_t bytes) {
+    lock_guard<mutex> lock(cacheMutex);
+
+    cacheBudget = bytes;
+    evictToBudget(cacheBudget);
+}
+
+void clearTessellationCache() {
+    lock_guard<mutex> lock(cacheMutex);
+
+    recency.clear();
+    entries.clear();
+    cacheBytes = 0;
+}
+
+TessellationCacheStats tessellationCacheStats() {
+    lock_guard<mutex> lock(cacheMutex);
+    TessellationCacheStats stats = { hits, misses, evictions, recency.size(), cacheBytes, cacheBudget };
+
+    return stats;
+}
+
+void resetTessellationCacheStats() {
+    lock_guard<mutex> lock(cacheMutex);
+
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
@@ -0,0 +1,59 @@
+//
+//  tessellation_cache.h
+//  mac_opengl_setup_example
+//
+//  Content-addressed LRU cache of per-curve tessellation results, shared by all curves of the scene.
+//  The key is a hash of the control points, the degree and the tessellation settings, so a curve
+//  dragged back to an earlier shape, or an identical copy of another curve, is not tessellated again.
+//
+
+#ifndef tessellation_cache_h
+#define tessellation_cache_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simplify.h"
+
+/* Alapértelmezett memóriakeret (--cache-budget <MiB>); 0 kikapcsolja a gyorsítótárat. */
+#define TESSELLATION_CACHE_BUDGET (16u << 20)
+
+/* Everything besides the control points that the samples of a curve depend on. */
+struct TessellationSettings {
+    GLfloat cubicTolerance;      // world units, see updateCubicApproximation
+    GLfloat pixelsPerUnit;       // level of detail
+    SimplifyMethod simplify;
+    GLfloat simplifyTolerance;   // world units
+};
+
+struct TessellationCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;                // estimated memory held by the entries
+    size_t budget;
+};
+
+uint64_t hashTessellationKey(const std::vector<glm::vec3>& controlPoints, const TessellationSettings& settings);
+
+/* On a hit appends the cached samples to out, sets outTessellatedCount to the sample count before
+   simplification and makes the entry the most recently used one. */
+bool lookupTessellation(const std::vector<glm::vec3>& controlPoints, const TessellationSettings& settings,
+                        std::vector<glm::vec3>& out, GLsizei& outTessellatedCount);
+
+/* Stores a result, evicting the least recently used entries to stay within the budget. */
+void storeTessellation(const std::vector<glm::vec3>& controlPoints, const TessellationSettings& settings,
+                       const glm::vec3* samples, GLsizei count, GLsizei tessellatedCount);
+
+/* Shrinks the cache to the new budget right away. */
+void setTessellationCacheBudget(size_t bytes);
+void clearTessellationCache();
+
+TessellationCacheStats tessellationCacheStats();
+void resetTessellationCacheStats();
+
+#endif /* tessellation_cache_h */
@@ -0,0 +1,245 @@
+//
+//  tessellation_worker.cpp
+//  mac_opengl_setup_example
+//
+
+#include "tessellation_worker.h"
+#include "tessellation_cache.h"
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+/* A worker saját példánya a jelenetből; csak a worker szál éri el. */
+static vector<BezierCurve> workerCurves;
+static Camera workerCamera;
+static int workerWidth, workerHeight;
+static VertexFormat workerFormat;
+static SimplifyMethod workerSimplify;
+
+/* A módosítások sorát a bemeneti szál tölti, a worker üríti. Csak a sor elérése zárolt, a tesszelálás nem. */
+static mutex editMutex;
+static condition_variable editPosted;
+static deque<SceneEdit> pendingEdits;
+static bool stopRequested = false;
+static atomic<uint64_t> postedSequence { 0 };
+
+static TripleBuffer<GeometryFrame> geometry;
+static thread worker;
+
+double workerClock() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void tessellateScene(vector<BezierCurve>& curves, const Camera& camera, int width, int height,
+                     SimplifyMethod simplify, GeometryFrame& out) {
+    out.vertices.clear();
+    out.curveFirsts.clear();
+    out.curveCounts.clear();
+    out.pointFirsts.clear();
+    out.pointCounts.clear();
+    out.simplify = simplify;
+    out.tessellatedSamples = 0;
+    out.simplifiedSamples = 0;
+
+    TessellationSettings settings;
+    settings.cubicTolerance = worldToleranceForView(camera, CUBIC_PIXEL_TOLERANCE, width, height);
+    settings.pixelsPerUnit = pixelsPerWorldUnit(camera, width, height);
+    settings.simplify = simplify;
+    settings.simplifyTolerance = worldToleranceForView(camera, SIMPLIFY_PIXEL_TOLERANCE, width, height);
+
+    vector<unsigned char> keep;
+
+    for (BezierCurve& curve : curves) {
+        glm::vec2 boxMin, boxMax;
+
+        if (curve.controlPoints.empty())
+            continue;
+
+        controlPointBounds(curve.controlPoints, boxMin, boxMax);
+        if (!isBoxVisible(camera, boxMin, boxMax))
+            continue;
+
+        GLint first = out.vertices.size();
+        GLsizei tessellated;
+
+        if (!lookupTessellation(curve.controlPoints, settings, out.vertices, tessellated)) {
+            /* A köbös darabok kontrollpoligonja jóval pontosabban becsüli a hosszt, mint egy magas fokszámú görbe cikk-cakkja. */
+            updateCubicApproximation(curve.cubics, curve.controlPoints, settings.cubicTolerance);
+
+            GLint segments = curveSegmentsForView(camera, curve.cubics.pieces, width, height);
+
+            /* A görbét a köbös közelítéséből rajzoljuk, a pontos kontrollpontok csak a szerkesztéshez és exporthoz kellenek. */
+            tessellateCubics(curve.cubics.pieces, segments, out.vertices);
+            tessellated = out.vertices.size() - first;
+
+            /* Egyszerűsítés helyben: a megtartott mintákat előre tömörítjük. */
+            keep.resize(tessellated);
+            simplifyPolyline(out.vertices.data() + first, tessellated, settings.simplifyTolerance, simplify, keep.data());
+            GLint kept = first;
+            for (GLsizei v = 0; v < tessellated; v++)
+                if (keep[v])
+                    out.vertices[kept++] = out.vertices[first + v];
+            out.vertices.resize(kept);
+
+            storeTessellation(curve.controlPoints, settings, out.vertices.data() + first, kept - first, tessellated);
+        }
+
+        GLint curvePoints = out.vertices.size() - first;
+        out.vertices.insert(out.vertices.end(), curve.controlPoints.begin(), curve.controlPoints.end());
+
+        out.curveFirsts.push_back(first);
+        out.curveCounts.push_back(curvePoints);
+        out.pointFirsts.push_back(first + curvePoints);
+        out.pointCounts.push_back(curve.controlPoints.size());
+        out.tessellatedSamples += tessellated;
+        out.simplifiedSamples += curvePoints;
+    }
+}
+
+void encodeFrame(GeometryFrame& frame, VertexFormat format, const Camera& camera, int width, int height) {
+    /* Egy görbe mintapontjai és kontrollpontjai egymás után következnek, közös kvantálási dobozt kapnak. */
+    vector<GLsizei> rangeCounts(frame.curveCounts.size());
+    for (size_t i = 0; i < rangeCounts.size(); i++)
+        rangeCounts[i] = frame.curveCounts[i] + frame.pointCounts[i];
+
+    frame.format = format;
+    frame.errorBound = encodeVertices(format, frame.vertices, frame.curveFirsts, rangeCounts, frame.packed, frame.quantization);
+
+    if (format == VERTEX_HALF2 && frame.errorBound * pixelsPerWorldUnit(camera, width, height) > HALF_MAX_PIXEL_ERROR) {
+        frame.format = VERTEX_FLOAT2;
+        frame.errorBound = encodeVertices(VERTEX_FLOAT2, frame.vertices, frame.curveFirsts, rangeCounts, frame.packed, frame.quantization);
+    }
+
+    frame.quantizationFirsts.clear();
+    frame.quantizationBlocks.clear();
+    if (frame.format == VERTEX_INT16)
+        buildQuantizationLookup(frame.curveFirsts, frame.vertices.size(), frame.quantizationFirsts, frame.quantizationBlocks);
+}
+
+static void applySceneEdit(const SceneEdit& edit) {
+    switch (edit.type) {
+        case EDIT_SET_POINT:
+            workerCurves[edit.curve].controlPoints[edit.index] = edit.point;
+            break;
+        case EDIT_ADD_POINT:
+            workerCurves[edit.curve].controlPoints.push_back(edit.point);
+            break;
+        case EDIT_REMOVE_POINT:
+            workerCurves[edit.curve].controlPoints.erase(workerCurves[edit.curve].controlPoints.begin() + edit.index);
+            break;
+        case EDIT_ADD_CURVE:
+            workerCurves.push_back(BezierCurve());
+            break;
+        case EDIT_SET_VIEW:
+            workerCamera = edit.camera;
+            workerWidth = edit.width;
+            workerHeight = edit.height;
+            break;
+        case EDIT_SET_VERTEX_FORMAT:
+            workerFormat = edit.format;
+            break;
+        case EDIT_SET_SIMPLIFY:
+            workerSimplify = edit.simplify;
+            break;
+    }
+}
+
+static void buildFrame(uint64_t sequence, double postedAt) {
+    GeometryFrame& frame = geometry.writeBuffer();
+
+    tessellateScene(workerCurves, workerCamera, workerWidth, workerHeight, workerSimplify, frame);
+    encodeFrame(frame, workerFormat, workerCamera, workerWidth, workerHeight);
+    frame.editSequence = sequence;
+    frame.newestEditPostedAt = postedAt;
+    frame.readyAt = workerClock();
+
+    geometry.publish();
+}
+
+static void workerLoop() {
+    deque<SceneEdit> edits;
+
+    buildFrame(0, workerClock());
+
+    for (;;) {
+        {
+            unique_lock<mutex> lock(editMutex);
+            editPosted.wait(lock, [] { return stopRequested || !pendingEdits.empty(); });
+            if (stopRequested)
+                return;
+            edits.swap(pendingEdits);
+        }
+
+        /* Az összegyűlt módosításokat egyszerre alkalmazzuk, és csak a legutolsó állapotot tesszeláljuk. */
+        for (const SceneEdit& edit : edits)
+            applySceneEdit(edit);
+
+        buildFrame(edits.back().sequence, edits.back().postedAt);
+        edits.clear();
+    }
+}
+
+void startTessellationWorker(const vector<BezierCurve>& curves, const Camera& camera, int width, int height,
+                             VertexFormat format, SimplifyMethod simplify) {
+    workerCurves = curves;
+    workerFormat = format;
+    workerSimplify = simplify;
+    workerCamera = camera;
+    workerWidth = width;
+    workerHeight = height;
+    stopRequested = false;
+
+    worker = thread(workerLoop);
+}
+
+void stopTessellationWorker() {
+    if (!worker.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(editMutex);
+        stopRequested = true;
+    }
+    editPosted.notify_one();
+    worker.join();
+}
+
+uint64_t postSceneEdit(SceneEdit edit) {
+    {
+        lock_guard<mutex> lock(editMutex);
+        edit.sequence = ++postedSequence;
+        edit.postedAt = workerClock();
+        pendingEdits.push_back(edit);
+    }
+    editPosted.notify_one();
+    return edit.sequence;
+}
+
+uint64_t lastPostedEdit() {
+    return postedSequence.load();
+}
+
+bool acquireLatestGeometry() {
+    return geometry.acquire();
+}
+
+const GeometryFrame& currentGeometry() {
+    return geometry.readBuffer();
+}
+
+GeometryStaleness currentStaleness() {
+    const GeometryFrame& frame = geometry.readBuffer();
+    GeometryStaleness staleness;
+
+    staleness.editsBehind = lastPostedEdit() - frame.editSequence;
+    staleness.latencyMs = (frame.readyAt - frame.newestEditPostedAt) * 1000.0;
+    staleness.ageMs = (workerClock() - frame.readyAt) * 1000.0;
+    return staleness;
+}
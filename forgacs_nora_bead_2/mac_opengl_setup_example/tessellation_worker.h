@@ -0,0 +1,103 @@
+//
+//  tessellation_worker.h
+//  mac_opengl_setup_example
+//
+//  Background tessellation: the input handlers post edits, a worker thread applies them to its own
+//  copy of the scene and builds the vertex data, and the render thread picks up the newest finished
+//  geometry through a triple buffer without blocking.
+//
+
+#ifndef tessellation_worker_h
+#define tessellation_worker_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "bezier.h"
+#include "camera.h"
+#include "simplify.h"
+#include "vertex_format.h"
+
+enum SceneEditType {
+    EDIT_SET_POINT,
+    EDIT_ADD_POINT,
+    EDIT_REMOVE_POINT,
+    EDIT_ADD_CURVE,
+    EDIT_SET_VIEW,
+    EDIT_SET_VERTEX_FORMAT,
+    EDIT_SET_SIMPLIFY,
+};
+
+struct SceneEdit {
+    SceneEditType type;
+    GLint curve;
+    GLint index;
+    glm::vec3 point;
+    Camera camera;
+    int width, height;
+    VertexFormat format;
+    SimplifyMethod simplify;
+
+    uint64_t sequence;      // filled in by postSceneEdit
+    double postedAt;
+};
+
+/* A kész geometria: minden látható görbe mintapontjai után a kontrollpontjai következnek. */
+struct GeometryFrame {
+    std::vector<glm::vec3> vertices;
+    std::vector<GLint>   curveFirsts, pointFirsts;
+    std::vector<GLsizei> curveCounts, pointCounts;
+
+    /* A VBO-ba kerülő kódolt változat; VERTEX_INT16 esetén görbénként saját kvantálási dobozzal, amelyet
+       a shader a quantizationFirsts és quantizationBlocks táblákkal keres meg (buildQuantizationLookup). */
+    VertexFormat format = VERTEX_FLOAT3;
+    std::vector<unsigned char> packed;
+    std::vector<glm::vec4> quantization;
+    std::vector<GLint> quantizationFirsts, quantizationBlocks;
+    GLfloat errorBound = 0.0f;          // world units
+
+    /* Görbementák száma az egyszerűsítés előtt és után (a kontrollpontok nélkül). */
+    SimplifyMethod simplify = SIMPLIFY_NONE;
+    size_t tessellatedSamples = 0;
+    size_t simplifiedSamples = 0;
+
+    uint64_t editSequence = 0;    // newest edit included in this frame
+    double newestEditPostedAt = 0.0;
+    double readyAt = 0.0;
+};
+
+struct GeometryStaleness {
+    uint64_t editsBehind;     // edits posted but not yet included in the displayed frame
+    double latencyMs;         // newest included edit posted -> frame ready
+    double ageMs;             // frame ready -> now
+};
+
+/* Tessellates and simplifies the visible curves of the scene into out (used by the worker and by tools).
+   Curves whose control points and settings are in the tessellation cache are copied from it. */
+void tessellateScene(std::vector<BezierCurve>& curves, const Camera& camera, int width, int height,
+                     SimplifyMethod simplify, GeometryFrame& out);
+
+/* Fills the packed vertex data of a tessellated frame. VERTEX_HALF2 falls back to VERTEX_FLOAT2
+   when its error bound would exceed HALF_MAX_PIXEL_ERROR pixels in the given view. */
+void encodeFrame(GeometryFrame& frame, VertexFormat format, const Camera& camera, int width, int height);
+
+/* Starts the worker with a copy of the scene and lets it build the first frame. */
+void startTessellationWorker(const std::vector<BezierCurve>& curves, const Camera& camera, int width, int height,
+                             VertexFormat format, SimplifyMethod simplify);
+void stopTessellationWorker();
+
+/* Never waits for tessellation; returns the sequence number of the edit. */
+uint64_t postSceneEdit(SceneEdit edit);
+uint64_t lastPostedEdit();
+
+/* Render thread: takes the newest finished frame if there is one. Returns true if the frame changed. */
+bool acquireLatestGeometry();
+const GeometryFrame& currentGeometry();
+GeometryStaleness currentStaleness();
+
+/* Seconds on the steady clock, the time base of postedAt/readyAt. */
+double workerClock();
+
+#endif /* tessellation_worker_h */
@@ -0,0 +1,48 @@
+//
+//  triple_buffer.h
+//  mac_opengl_setup_example
+//
+//  Lock-free single producer / single consumer triple buffer. The producer always has a buffer to
+//  write into, the consumer always has a complete buffer to read, and neither ever waits for the other.
+//
+
+#ifndef triple_buffer_h
+#define triple_buffer_h
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    /* Producer side: the buffer that is currently being filled. */
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    /* Producer side: hands the filled buffer over and takes the previous middle buffer for the next write. */
+    void publish() {
+        writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /* Consumer side: swaps in the newest published buffer, if there is one. Returns true on a new buffer. */
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /* Consumer side: the newest buffer acquired so far. */
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;
+
+    T buffers[3];
+    /* A középső puffer indexe és egy jelzőbit, hogy a termelő azóta publikált-e. */
+    std::atomic<unsigned> middle { 1 };
+    unsigned writeIndex = 0;
+    unsigned readIndex = 2;
+};
+
+#endif /* triple_buffer_h */
@@ -0,0 +1,177 @@
+//
+//  vertex_format.cpp
+//  mac_opengl_setup_example
+//
+
+#include "vertex_format.h"
+
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+using namespace std;
+
+static const char* formatNames[VERTEX_FORMAT_COUNT] = { "float3", "float2", "half", "int16" };
+
+const char* vertexFormatName(VertexFormat format) {
+    return formatNames[format];
+}
+
+bool parseVertexFormat(const char* name, VertexFormat& outFormat) {
+    for (int i = 0; i < VERTEX_FORMAT_COUNT; i++)
+        if (strcmp(name, formatNames[i]) == 0) {
+            outFormat = (VertexFormat)i;
+            return true;
+        }
+    return false;
+}
+
+GLsizei vertexFormatStride(VertexFormat format) {
+    switch (format) {
+        case VERTEX_FLOAT3: return 3 * sizeof(GLfloat);
+        case VERTEX_FLOAT2: return 2 * sizeof(GLfloat);
+        case VERTEX_HALF2:  return 2 * sizeof(GLhalf);
+        case VERTEX_INT16:  return 2 * sizeof(GLshort);
+    }
+    return 0;
+}
+
+void setVertexAttribFormat(VertexFormat format) {
+    /* A kihagyott z komponens a shaderben 0 lesz, így a vertex shader mindegyik formátummal ugyanaz. */
+    switch (format) {
+        case VERTEX_FLOAT3:
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexFormatStride(format), (void*)0);
+            break;
+        case VERTEX_FLOAT2:
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, vertexFormatStride(format), (void*)0);
+            break;
+        case VERTEX_HALF2:
+            glVertexAttribPointer(0, 2, GL_HALF_FLOAT, GL_FALSE, vertexFormatStride(format), (void*)0);
+            break;
+        case VERTEX_INT16:
+            /* Nem normalizált: a short -> [-1, 1] leképezés a GL 4.2 előtt és után más (c / 32767 vagy
+               (2c + 1) / 65535), ezért a shader maga szoroz a doboz lépésközével. */
+            glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, vertexFormatStride(format), (void*)0);
+            break;
+    }
+}
+
+static glm::vec4 quantizationBox(const vector<glm::vec3>& vertices, GLint first, GLsizei count) {
+    glm::vec2 boxMin = glm::vec2(INFINITY, INFINITY);
+    glm::vec2 boxMax = glm::vec2(-INFINITY, -INFINITY);
+
+    for (GLint i = first; i < first + count; i++) {
+        boxMin = glm::min(boxMin, glm::vec2(vertices[i].x, vertices[i].y));
+        boxMax = glm::max(boxMax, glm::vec2(vertices[i].x, vertices[i].y));
+    }
+
+    glm::vec2 center = (boxMin + boxMax) * 0.5f;
+    glm::vec2 halfExtent = (boxMax - boxMin) * 0.5f;
+
+    /* Egyetlen pontból álló (vagy tengellyel párhuzamos) tartománynál ne osszunk nullával. */
+    if (halfExtent.x <= 0.0f) halfExtent.x = 1.0f;
+    if (halfExtent.y <= 0.0f) halfExtent.y = 1.0f;
+    return glm::vec4(center.x, center.y, halfExtent.x, halfExtent.y);
+}
+
+static GLshort quantize(GLfloat value, GLfloat center, GLfloat halfExtent) {
+    GLfloat normalized = glm::clamp((value - center) / halfExtent, -1.0f, 1.0f);
+    return (GLshort)lroundf(normalized * 32767.0f);
+}
+
+GLfloat encodeVertices(VertexFormat format, const vector<glm::vec3>& vertices,
+                       const vector<GLint>& rangeFirsts, const vector<GLsizei>& rangeCounts,
+                       vector<unsigned char>& outBytes, vector<glm::vec4>& outQuantization) {
+    const glm::vec4 identity = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    GLfloat errorBound = 0.0f;
+
+    outBytes.resize(vertices.size() * vertexFormatStride(format));
+    outQuantization.assign(rangeFirsts.size(), identity);
+
+    switch (format) {
+        case VERTEX_FLOAT3:
+            memcpy(outBytes.data(), vertices.data(), outBytes.size());
+            break;
+
+        case VERTEX_FLOAT2: {
+            GLfloat* out = (GLfloat*)outBytes.data();
+            for (size_t i = 0; i < vertices.size(); i++) {
+                out[2 * i] = vertices[i].x;
+                out[2 * i + 1] = vertices[i].y;
+            }
+            break;
+        }
+
+        case VERTEX_HALF2: {
+            GLuint* out = (GLuint*)outBytes.data();
+            GLfloat maxMagnitude = 0.0f;
+            for (size_t i = 0; i < vertices.size(); i++) {
+                out[i] = glm::packHalf2x16(glm::vec2(vertices[i].x, vertices[i].y));
+                maxMagnitude = fmaxf(maxMagnitude, fmaxf(fabsf(vertices[i].x), fabsf(vertices[i].y)));
+            }
+            /* 11 bites mantissza, kerekítéssel fél egységnyi hiba az utolsó helyiértéken. */
+            errorBound = maxMagnitude * exp2f(-11.0f);
+            break;
+        }
+
+        case VERTEX_INT16: {
+            GLshort* out = (GLshort*)outBytes.data();
+            for (size_t r = 0; r < rangeFirsts.size(); r++) {
+                glm::vec4 box = quantizationBox(vertices, rangeFirsts[r], rangeCounts[r]);
+
+                for (GLint i = rangeFirsts[r]; i < rangeFirsts[r] + rangeCounts[r]; i++) {
+                    out[2 * i] = quantize(vertices[i].x, box.x, box.z);
+                    out[2 * i + 1] = quantize(vertices[i].y, box.y, box.w);
+                }
+
+                outQuantization[r] = glm::vec4(box.x, box.y, box.z / 32767.0f, box.w / 32767.0f);
+
+                /* Fél kvantálási lépés, plusz a shader center + q * step számításának float kerekítése. */
+                GLfloat halfExtent = fmaxf(box.z, box.w);
+                GLfloat magnitude = fmaxf(fabsf(box.x), fabsf(box.y)) + halfExtent;
+                errorBound = fmaxf(errorBound, halfExtent / 32767.0f * 0.5f + magnitude * exp2f(-22.0f));
+            }
+            break;
+        }
+    }
+
+    return errorBound;
+}
+
+void buildQuantizationLookup(const vector<GLint>& rangeFirsts, GLsizei vertexCount,
+                             vector<GLint>& outFirsts, vector<GLint>& outBlocks) {
+    outFirsts.assign(rangeFirsts.begin(), rangeFirsts.end());
+    outFirsts.push_back(vertexCount);     // őrszem: a shader keresése itt mindig megáll
+
+    /* A blokk első vertexénél nem később kezdődő utolsó tartomány; a shader innen lép előre. */
+    GLsizei blocks = (vertexCount + (1 << QUANTIZATION_BLOCK_SHIFT) - 1) >> QUANTIZATION_BLOCK_SHIFT;
+    outBlocks.resize(blocks);
+    for (GLsizei b = 0; b < blocks; b++) {
+        auto next = upper_bound(rangeFirsts.begin(), rangeFirsts.end(), b << QUANTIZATION_BLOCK_SHIFT);
+        outBlocks[b] = max(0, (GLint)(next - rangeFirsts.begin()) - 1);
+    }
+}
+
+glm::vec2 decodeVertex(VertexFormat format, const vector<unsigned char>& bytes, size_t index, glm::vec4 quantization) {
+    switch (format) {
+        case VERTEX_FLOAT3: {
+            const GLfloat* in = (const GLfloat*)bytes.data();
+            return glm::vec2(in[3 * index], in[3 * index + 1]);
+        }
+        case VERTEX_FLOAT2: {
+            const GLfloat* in = (const GLfloat*)bytes.data();
+            return glm::vec2(in[2 * index], in[2 * index + 1]);
+        }
+        case VERTEX_HALF2: {
+            const GLuint* in = (const GLuint*)bytes.data();
+            return glm::unpackHalf2x16(in[index]);
+        }
+        case VERTEX_INT16: {
+            const GLshort* in = (const GLshort*)bytes.data();
+            glm::vec2 quantized = glm::vec2(in[2 * index], in[2 * index + 1]);
+            return glm::vec2(quantization.x, quantization.y) + quantized * glm::vec2(quantization.z, quantization.w);
+        }
+    }
+    return glm::vec2(0.0f, 0.0f);
+}
@@ -0,0 +1,58 @@
+//
+//  vertex_format.h
+//  mac_opengl_setup_example
+//
+//  Compact encodings of the curve and marker vertices uploaded to the VBO.
+//
+
+#ifndef vertex_format_h
+#define vertex_format_h
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+enum VertexFormat {
+    VERTEX_FLOAT3 = 0,   // 12 bytes, the original layout (z is always 0)
+    VERTEX_FLOAT2 = 1,   //  8 bytes
+    VERTEX_HALF2 = 2,    //  4 bytes, absolute coordinates in half precision
+    VERTEX_INT16 = 3,    //  4 bytes, shorts relative to each range's bounding box
+};
+
+#define VERTEX_FORMAT_COUNT 4
+
+/* A half-float pontosság nagy koordinátáknál romlik; ha a hibakorlát ennél több pixel, float2-re váltunk. */
+#define HALF_MAX_PIXEL_ERROR 0.5f
+
+/* int16 vertexeknél a shader 2^6 = 64 vertexes blokkonként tudja, melyik tartománnyal kezdődik a blokk
+   (a vertex_shader.glsl-ben ugyanez az érték). */
+#define QUANTIZATION_BLOCK_SHIFT 6
+
+const char* vertexFormatName(VertexFormat format);
+bool parseVertexFormat(const char* name, VertexFormat& outFormat);
+GLsizei vertexFormatStride(VertexFormat format);
+
+/* Configures attribute 0 of the bound VAO for the format (the VBO must be bound). */
+void setVertexAttribFormat(VertexFormat format);
+
+/*
+Encodes vertices into outBytes. Each [first, first + count) range gets its own quantization box
+(center.xy, step.xy) in outQuantization, decoded as center + short * step; for formats other than
+VERTEX_INT16 the box is the identity (0, 0, 1, 1). Returns the worst-case per-coordinate error in world units.
+*/
+GLfloat encodeVertices(VertexFormat format, const std::vector<glm::vec3>& vertices,
+                       const std::vector<GLint>& rangeFirsts, const std::vector<GLsizei>& rangeCounts,
+                       std::vector<unsigned char>& outBytes, std::vector<glm::vec4>& outQuantization);
+
+/*
+Tables with which the vertex shader finds the box of gl_VertexID, so int16 frames can be drawn with
+glMultiDrawArrays: outFirsts is rangeFirsts followed by vertexCount, outBlocks holds for every block of
+2^QUANTIZATION_BLOCK_SHIFT vertices the last range starting at or before the block.
+*/
+void buildQuantizationLookup(const std::vector<GLint>& rangeFirsts, GLsizei vertexCount,
+                             std::vector<GLint>& outFirsts, std::vector<GLint>& outBlocks);
+
+/* CPU side of the vertex shader's dequantization, used to check the error bound. */
+glm::vec2 decodeVertex(VertexFormat format, const std::vector<unsigned char>& bytes, size_t index, glm::vec4 quantization);
+
+#endif /* vertex_format_h */
@@ -0,0 +1,51 @@
+#version 430 core
+
+/* Kötegelt tesszelálás: minden szál egyetlen mintapontot számol, a görbe indexe és a paraméter a globális azonosítóból adódik. */
+layout (local_size_x = 64) in;
+
+/* Ennél magasabb fokszámú görbéket a CPU számolja (a vezérlő program ezeknél 0 kontrollpontot ad meg). */
+#define MAX_DEGREE 31
+
+/* Az összes görbe kontrollpontja egyszerre feltöltve. */
+layout (std430, binding = 0) readonly buffer ControlPoints {
+    vec2 controlPoints[];
+};
+
+/* curves[i] = (az első kontrollpont indexe, a kontrollpontok száma) */
+layout (std430, binding = 1) readonly buffer Curves {
+    uvec2 curves[];
+};
+
+/* A darab mintái görbénként egymás után, segments + 1 darab görbénként. */
+layout (std430, binding = 2) writeonly buffer Samples {
+    vec2 samples[];
+};
+
+uniform uint firstCurve;
+uniform uint curveCount;
+uniform uint segments;
+
+void main(void)
+{
+    uint samplesPerCurve = segments + 1u;
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= curveCount * samplesPerCurve)
+        return;
+
+    uvec2 range = curves[firstCurve + id / samplesPerCurve];
+    if (range.y == 0u) {
+        samples[id] = vec2(0.0);
+        return;
+    }
+
+    /* de Casteljau, ugyanúgy, mint az evaluateBezier a CPU-n. */
+    float t = float(id % samplesPerCurve) / float(segments);
+    vec2 work[MAX_DEGREE + 1];
+    for (uint i = 0u; i < range.y; i++)
+        work[i] = controlPoints[range.x + i];
+    for (uint r = range.y - 1u; r > 0u; r--)
+        for (uint i = 0u; i < r; i++)
+            work[i] = work[i] * (1.0 - t) + work[i + 1u] * t;
+
+    samples[id] = work[0];
+}
@@ -24,7 +24,33 @@
 
 layout (location = 0) in vec3 aPos;
 
+/* világkoordináta -> NDC (pásztázás és nagyítás) */
+uniform mat4 view;
+
+/* int16 vertexeknél a shorttól a világkoordinátáig: görbénként egy doboz, xy a középpont, zw a lépésköz.
+   A többi formátumnál quantized hamis, a pozíció változatlan marad. */
+uniform bool quantized;
+uniform samplerBuffer quantizationBoxes;
+
+/* Melyik doboz tartozik a vertexhez: a tartományok első vertexei (a végén a vertexek számával), és
+   64 vertexes blokkonként a blokk elején érvényes tartomány (QUANTIZATION_BLOCK_SHIFT a vertex_format.h-ban). */
+uniform isamplerBuffer quantizationFirsts;
+uniform isamplerBuffer quantizationBlocks;
+
+#define QUANTIZATION_BLOCK_SHIFT 6
+
 void main(void)
 {
-    gl_Position = vec4(aPos, 1.0);
+    vec2 position = aPos.xy;
+
+    if (quantized) {
+        /* glMultiDrawArrays mellett a gl_VertexID a pufferbeli index, így a görbét is ebből kapjuk meg. */
+        int range = texelFetch(quantizationBlocks, gl_VertexID >> QUANTIZATION_BLOCK_SHIFT).x;
+        while (texelFetch(quantizationFirsts, range + 1).x <= gl_VertexID)
+            range++;
+
+        vec4 box = texelFetch(quantizationBoxes, range);
+        position = box.xy + aPos.xy * box.zw;
+    }
+    gl_Position = view * vec4(position, aPos.z, 1.0);
 }